@@ -1,13 +1,7 @@
 #include "DiskStreamer.h"
-
-// Debug logging to file (same as PluginProcessor)
-static void streamDebugLog(const juce::String& msg)
-{
-    auto logFile = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
-                       .getChildFile("sampler_streaming_debug.txt");
-    auto timestamp = juce::Time::getCurrentTime().toString(true, true, true, true);
-    logFile.appendText("[" + timestamp + "] " + msg + "\n");
-}
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
 
 DiskStreamer::DiskStreamer()
     : juce::Thread("DiskStreamer")
@@ -15,9 +9,6 @@ DiskStreamer::DiskStreamer()
     // Initialize all voice pointers to null
     for (auto& voice : voices)
         voice.store(nullptr, std::memory_order_relaxed);
-
-    // Allocate temporary buffer for disk reads (stereo)
-    tempReadBuffer.setSize(2, StreamingConstants::diskReadFrames);
 }
 
 DiskStreamer::~DiskStreamer()
@@ -28,23 +19,40 @@ DiskStreamer::~DiskStreamer()
 void DiskStreamer::startThread()
 {
     juce::Thread::startThread();
+
+    // The decode worker runs below the disk thread: compressed fills have a
+    // whole ring of slack, while the PCM tier's fills are deadline-driven
+    decodeWorker.startThread(juce::Thread::Priority::low);
 }
 
 void DiskStreamer::stopThread()
 {
+    decodeWorker.signalThreadShouldExit();
     signalThreadShouldExit();
-    notify();  // Wake up the thread if it's waiting
+    decodeQueue.wake();
+    requestQueue.wake();  // Wake up the thread if it's blocked on the queue
+
+    decodeWorker.stopThread(1000);
     juce::Thread::stopThread(1000);
 
-    // Clean up readers
-    for (auto& reader : readers)
-        reader.reset();
+    // Clean up readers (both threads are stopped, so this is safe)
+    voiceReaders.fill(nullptr);
+    readerCache.clear();
+
+    for (auto& slot : decoderSlots)
+    {
+        slot.reader = nullptr;
+        slot.filePath.clear();
+    }
 }
 
 void DiskStreamer::registerVoice(int voiceIndex, StreamingVoice* voice)
 {
     if (voiceIndex >= 0 && voiceIndex < StreamingConstants::maxStreamingVoices)
     {
+        if (voice != nullptr)
+            voice->setRequestQueue(&requestQueue, voiceIndex);
+
         voices[static_cast<size_t>(voiceIndex)].store(voice, std::memory_order_release);
     }
 }
@@ -60,53 +68,297 @@ void DiskStreamer::unregisterVoice(int voiceIndex)
 
 void DiskStreamer::run()
 {
-    streamDebugLog(">>> DiskStreamer thread STARTED");
-    int loopCount = 0;
-    int lastActiveVoices = 0;
+    Trace::post(Trace::Event::streamerStarted, -1);
 
     while (!threadShouldExit())
     {
-        loopCount++;
-        int activeVoices = 0;
+        // Block until a voice requests data (or the safety timeout elapses)
+        requestQueue.waitForRequest(StreamingConstants::diskThreadIdleTimeoutMs);
 
-        // Poll all registered voices
-        for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
+        if (threadShouldExit())
+            break;
+
+        // The queue is just a wakeup: drain it, then schedule from the
+        // voices' own flags so urgency ordering covers every needy voice
+        // (including any whose request was lost in a race)
+        int requestedVoice = -1;
+        while (requestQueue.pop(requestedVoice))
+        {
+        }
+
+        serviceNeedyVoices(*this, false);
+
+        // With no fills pending, spend idle time on predictive warming.
+        // The popped set reference keeps the sample alive across the warm
+        // even if its instrument has been retired since the hint was queued.
+        const PreloadedSample* toWarm = nullptr;
+        std::shared_ptr<const PreloadedSampleSet> warmOwner;
+        while (popWarmRequest(toWarm, warmOwner) && !threadShouldExit())
+        {
+            warmSample(toWarm);
+            warmOwner.reset();
+
+            if (requestQueue.waitForRequest(0))
+                break;  // a voice needs data - fills take priority
+        }
+    }
+
+    Trace::post(Trace::Event::streamerStopped, -1);
+}
+
+void DiskStreamer::runDecodeWorker()
+{
+    while (!decodeWorker.threadShouldExit())
+    {
+        decodeQueue.waitForRequest(StreamingConstants::diskThreadIdleTimeoutMs);
+
+        if (decodeWorker.threadShouldExit())
+            break;
+
+        // Same pattern as run(): the queue is only a wakeup, the sweep
+        // schedules from the voices' own flags
+        int requestedVoice = -1;
+        while (decodeQueue.pop(requestedVoice))
         {
-            if (threadShouldExit())
-                break;
+        }
+
+        serviceNeedyVoices(decodeWorker, true);
+    }
+}
+
+bool DiskStreamer::isCompressedFile(const juce::String& filePath)
+{
+    auto extension = filePath.fromLastOccurrenceOf(".", true, false).toLowerCase();
+    return extension == ".flac" || extension == ".ogg" || extension == ".mp3";
+}
 
+void DiskStreamer::requestWarm(const PreloadedSample* sample,
+                               std::shared_ptr<const PreloadedSampleSet> owner)
+{
+    if (sample == nullptr || owner == nullptr)
+        return;
+
+    int start1, size1, start2, size2;
+    warmFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+    {
+        auto& slot = warmSlots[static_cast<size_t>(start1)];
+        slot.sample = sample;
+        slot.owner = std::move(owner);
+        warmFifo.finishedWrite(1);
+        requestQueue.wake();
+    }
+    // Queue full: drop the hint - warming is best-effort
+}
+
+bool DiskStreamer::popWarmRequest(const PreloadedSample*& sample,
+                                  std::shared_ptr<const PreloadedSampleSet>& owner)
+{
+    int start1, size1, start2, size2;
+    warmFifo.prepareToRead(1, start1, size1, start2, size2);
+
+    if (size1 <= 0)
+        return false;
+
+    auto& slot = warmSlots[static_cast<size_t>(start1)];
+    sample = slot.sample;
+    owner = std::move(slot.owner);
+    warmFifo.finishedRead(1);
+    return true;
+}
+
+void DiskStreamer::warmSample(const PreloadedSample* sample)
+{
+    if (sample == nullptr || !sample->isValid() || !sample->needsStreaming())
+        return;
+
+    auto nowMs = juce::Time::getMillisecondCounter();
+
+    // Already warm? Just refresh its LRU stamp
+    for (auto& entry : warmCache)
+    {
+        if (entry.filePath == sample->filePath)
+        {
+            entry.lastUsedMs = nowMs;
+            return;
+        }
+    }
+
+    // Evict the least recently used slot
+    auto* lru = &warmCache[0];
+    for (auto& entry : warmCache)
+    {
+        if (entry.lastUsedMs < lru->lastUsedMs)
+            lru = &entry;
+    }
+
+    // Going through the shared cache means the opened handle also stays
+    // around for the voice that will stream this file next
+    auto* shared = acquireReader(sample->filePath);
+    if (shared == nullptr)
+        return;
+
+    auto* reader = shared->reader.get();
+
+    // Read the region a streaming voice will ask for first: the chunk
+    // immediately after the preload
+    auto startFrame = static_cast<int64_t>(sample->preloadSizeFrames);
+    auto framesLeft = static_cast<int64_t>(reader->lengthInSamples) - startFrame;
+    int framesToWarm = static_cast<int>(std::min<int64_t>(framesLeft,
+                                                          StreamingConstants::diskReadFrames * 2));
+
+    if (framesToWarm > 0)
+    {
+        int numChannels = std::min(static_cast<int>(reader->numChannels), 2);
+
+        lru->firstChunk.setSize(numChannels, framesToWarm, false, false, true);
+        reader->read(&lru->firstChunk, 0, framesToWarm, startFrame, true, true);
+    }
+
+    releaseReader(shared);
+
+    if (framesToWarm <= 0)
+        return;
+
+    lru->filePath = sample->filePath;
+    lru->lastUsedMs = nowMs;
+
+    Trace::post(Trace::Event::warmed, -1, framesToWarm);
+}
+
+void DiskStreamer::serviceNeedyVoices(juce::Thread& worker, bool compressedTier)
+{
+    struct Candidate
+    {
+        int voiceIndex;
+        double framesToStarvation;    // output frames until the ring runs dry
+        const PreloadedSample* sample;
+        int64_t streamPosition;       // next read position (file order proxy)
+    };
+
+    // A voice this close to underrun is serviced strictly by urgency; the
+    // rest can afford to wait for a seek-friendly ordering
+    constexpr double urgentThresholdFrames = StreamingConstants::lowWatermarkFrames / 2;
+
+    std::array<Candidate, StreamingConstants::maxStreamingVoices> candidates;
+
+    // Bursts are capped, so one pass may leave the neediest voices still
+    // below the watermark - keep re-scanning until every ring is safe
+    while (!worker.threadShouldExit())
+    {
+        int numCandidates = 0;
+        bool sawCompressedWork = false;
+
+        for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
+        {
             StreamingVoice* voice = voices[static_cast<size_t>(i)].load(std::memory_order_acquire);
-            if (voice != nullptr && voice->isActive())
+            if (voice == nullptr || !voice->isActive() || !voice->needsMoreData())
+                continue;
+
+            // Each tier only services its own voices; the disk thread hands
+            // compressed work to the decode worker with a wakeup below
+            const PreloadedSample* sample = voice->getCurrentSample();
+            bool compressed = sample != nullptr && isCompressedFile(sample->filePath);
+            if (compressed != compressedTier)
             {
-                activeVoices++;
-                if (voice->needsMoreData())
-                {
-                    fillVoiceBuffer(i);
-                }
+                sawCompressedWork = sawCompressedWork || compressed;
+                continue;
             }
+
+            // Time-to-starvation in output frames: a pitched-up voice
+            // consumes ring frames faster, so it is proportionally more
+            // urgent than its raw fill level suggests
+            double pitchRatio = std::max(voice->getPitchRatio(), 0.01);
+            candidates[static_cast<size_t>(numCandidates++)] =
+                { i, static_cast<double>(voice->samplesAvailable()) / pitchRatio,
+                  sample, voice->getFileReadPosition() };
         }
 
-        // Log heartbeat and voice count changes
-        if (loopCount % 200 == 0)  // Every ~1 second at 5ms polling
+        if (!compressedTier && sawCompressedWork)
+            decodeQueue.wake();
+
+        if (numCandidates == 0)
+            return;
+
+        // Voices near starvation jump the queue in urgency order; everyone
+        // else is batched by (file, offset) so a chord's ten fills become a
+        // few ascending runs through each file instead of ten interleaved
+        // seeks. Back-to-back reads on one file share its cached reader, and
+        // adjacent ranges coalesce naturally: memory-mapped formats convert
+        // out of one contiguous mapped region, and buffered formats ride the
+        // OS readahead that sequential access keeps primed.
+        auto* firstLazy = std::partition(candidates.begin(), candidates.begin() + numCandidates,
+                                         [](const Candidate& c)
+                                         {
+                                             return c.framesToStarvation < urgentThresholdFrames;
+                                         });
+
+        std::sort(candidates.begin(), firstLazy,
+                  [](const Candidate& a, const Candidate& b)
+                  {
+                      return a.framesToStarvation < b.framesToStarvation;
+                  });
+
+        std::sort(firstLazy, candidates.begin() + numCandidates,
+                  [](const Candidate& a, const Candidate& b)
+                  {
+                      if (a.sample != b.sample && a.sample != nullptr && b.sample != nullptr)
+                      {
+                          int order = a.sample->filePath.compare(b.sample->filePath);
+                          if (order != 0)
+                              return order < 0;
+                      }
+                      return a.streamPosition < b.streamPosition;
+                  });
+
+        for (int i = 0; i < numCandidates && !worker.threadShouldExit(); ++i)
         {
-            streamDebugLog("DiskStreamer heartbeat: loop=" + juce::String(loopCount)
-                          + " activeVoices=" + juce::String(activeVoices));
+            int voiceIndex = candidates[static_cast<size_t>(i)].voiceIndex;
+            if (compressedTier)
+                fillCompressedVoice(voiceIndex, worker);
+            else
+                fillVoiceBuffer(voiceIndex, worker);
         }
-        else if (activeVoices != lastActiveVoices)
+    }
+}
+
+void DiskStreamer::fillVoiceBuffer(int voiceIndex, juce::Thread& worker)
+{
+    StreamingVoice* voice = voices[static_cast<size_t>(voiceIndex)].load(std::memory_order_acquire);
+    if (voice == nullptr)
+        return;
+
+    const PreloadedSample* sample = voice->getCurrentSample();
+    if (sample == nullptr || !sample->isValid())
+        return;
+
+    Trace::post(Trace::Event::fillEnter, voiceIndex, voice->getFileReadPosition());
+
+    // Borrow a shared reader, swapping only if this voice changed files
+    auto*& shared = voiceReaders[static_cast<size_t>(voiceIndex)];
+    if (shared == nullptr || shared->filePath != sample->filePath)
+    {
+        if (shared != nullptr)
         {
-            streamDebugLog("DiskStreamer: activeVoices changed " + juce::String(lastActiveVoices)
-                          + " -> " + juce::String(activeVoices));
-            lastActiveVoices = activeVoices;
+            releaseReader(shared);
+            shared = nullptr;
         }
 
-        // Wait before polling again (but can be woken early)
-        wait(StreamingConstants::diskThreadPollMs);
+        shared = acquireReader(sample->filePath);
+
+        if (shared == nullptr)
+        {
+            voice->setReadError(true);
+            voice->clearNeedsData();
+            return;
+        }
     }
 
-    streamDebugLog(">>> DiskStreamer thread STOPPED");
+    fillVoiceFromReader(voiceIndex, voice, sample, shared->reader.get(), loopBlendBuffer, worker);
 }
 
-void DiskStreamer::fillVoiceBuffer(int voiceIndex)
+void DiskStreamer::fillCompressedVoice(int voiceIndex, juce::Thread& worker)
 {
     StreamingVoice* voice = voices[static_cast<size_t>(voiceIndex)].load(std::memory_order_acquire);
     if (voice == nullptr)
@@ -116,96 +368,172 @@ void DiskStreamer::fillVoiceBuffer(int voiceIndex)
     if (sample == nullptr || !sample->isValid())
         return;
 
-    streamDebugLog("fillVoiceBuffer[" + juce::String(voiceIndex) + "] ENTER - sample=" + sample->name);
+    Trace::post(Trace::Event::fillEnter, voiceIndex, voice->getFileReadPosition());
 
-    // Check if we need to open or reopen the file reader
-    auto& reader = readers[static_cast<size_t>(voiceIndex)];
-    if (reader == nullptr || readerFilePaths[static_cast<size_t>(voiceIndex)] != sample->filePath)
+    // Private decoder per voice slot, never shared: sharing a FLAC reader
+    // between voices at different positions forces a seek-and-resync on
+    // every handover, which is exactly the cost this tier exists to avoid.
+    // Kept across fills so sequential chunks continue the previous decode.
+    auto& slot = decoderSlots[static_cast<size_t>(voiceIndex)];
+    if (slot.reader == nullptr || slot.filePath != sample->filePath)
     {
-        reader = openReader(sample->filePath);
-        readerFilePaths[static_cast<size_t>(voiceIndex)] = sample->filePath;
+        slot.reader = openReader(sample->filePath);
+        slot.filePath = sample->filePath;
 
-        if (reader == nullptr)
+        if (slot.reader == nullptr)
         {
+            slot.filePath.clear();
             voice->setReadError(true);
             voice->clearNeedsData();
             return;
         }
     }
 
-    // Get current file position and available space
+    fillVoiceFromReader(voiceIndex, voice, sample, slot.reader.get(), decodeBlendBuffer, worker);
+}
+
+void DiskStreamer::fillVoiceFromReader(int voiceIndex, StreamingVoice* voice,
+                                       const PreloadedSample* sample, juce::AudioFormatReader* reader,
+                                       juce::AudioBuffer<float>& blendScratch, juce::Thread& worker)
+{
+    // Get current stream position and available space. For looping samples
+    // the stream position climbs monotonically forever; it is mapped onto
+    // file offsets through the loop below.
     int64_t filePos = voice->getFileReadPosition();
     int64_t totalFrames = static_cast<int64_t>(reader->lengthInSamples);
 
-    // Check for end of file
-    if (filePos >= totalFrames)
+    const bool looping = sample->hasLoop();
+    const int64_t loopStart = juce::jlimit<int64_t>(0, totalFrames, sample->loopStartFrame);
+    const int64_t loopEnd = juce::jlimit<int64_t>(loopStart, totalFrames, sample->loopEndFrame);
+    const int64_t loopLength = loopEnd - loopStart;
+    const auto crossfade = (looping && loopLength > 0)
+        ? static_cast<int>(std::min<int64_t>({ StreamingConstants::loopCrossfadeFrames,
+                                               loopStart, loopLength }))
+        : 0;
+
+    // Stream position -> file offset (identity until the first wrap)
+    auto mapToFile = [&](int64_t streamPos) -> int64_t
+    {
+        if (!looping || loopLength <= 0 || streamPos < loopEnd)
+            return streamPos;
+        return loopStart + (streamPos - loopStart) % loopLength;
+    };
+
+    // Check for end of file (loops never end)
+    if (!looping && filePos >= totalFrames)
     {
         voice->setEndOfFile(true);
         voice->clearNeedsData();
         return;
     }
 
+    // Read sizing from the active device policy, sampled once per visit.
+    // The chunk can never exceed what the ring can hold.
+    const int chunkFrames = std::min(readChunkFrames.load(std::memory_order_relaxed),
+                                     StreamingConstants::ringBufferFrames / 2);
+    const int burstCapFrames = std::max(maxBurstFrames.load(std::memory_order_relaxed), chunkFrames);
+
     // Calculate how much we can read
     int space = voice->spaceAvailable();
-    if (space < StreamingConstants::diskReadFrames)
+    if (space < chunkFrames)
     {
         // Ring buffer is nearly full - clear needsData and wait
         voice->clearNeedsData();
         return;
     }
 
-    // Fill the buffer in chunks
+    // Fill the buffer in chunks, reading straight into the ring buffer.
+    // Each chunk is at most two contiguous spans (split at the ring wrap),
+    // so a memory-mapped reader converts directly from the mapped region
+    // with no intermediate copy.
+    constexpr int ringFrames = StreamingConstants::ringBufferFrames;
     int totalFramesFilled = 0;
-    while (space >= StreamingConstants::diskReadFrames && filePos < totalFrames && !threadShouldExit())
+    auto fillStartTicks = juce::Time::getHighResolutionTicks();
+
+    while (space >= chunkFrames && (looping || filePos < totalFrames)
+           && totalFramesFilled < burstCapFrames
+           && !worker.threadShouldExit())
     {
-        int framesToRead = static_cast<int>(std::min(static_cast<int64_t>(StreamingConstants::diskReadFrames),
-                                                      totalFrames - filePos));
+        int framesToRead = chunkFrames;
+        if (!looping)
+            framesToRead = static_cast<int>(std::min<int64_t>(framesToRead, totalFrames - filePos));
         framesToRead = std::min(framesToRead, space);
 
         if (framesToRead <= 0)
             break;
 
-        // Clear temp buffer
-        tempReadBuffer.clear();
+        int writePos = voice->getWritePosition();
+        int sourceChannels = std::min(sample->numChannels, 2);
 
-        // Read from disk
-        bool success = reader->read(&tempReadBuffer, 0, framesToRead,
-                                    filePos, true, true);
+        // Invariant: the write head advances in lockstep with the stream
+        // position, so stream frame filePos always lands at its modulo slot
+        jassert(writePos == static_cast<int>(filePos % ringFrames));
 
-        if (!success)
+        bool success = true;
+        int framesDone = 0;
+
+        while (framesDone < framesToRead && success)
         {
-            voice->setReadError(true);
-            break;
-        }
+            int64_t fileOffset = mapToFile(filePos + framesDone);
 
-        // Copy to voice's ring buffer
-        int writePos = voice->getWritePosition();
-        int numChannels = std::min(tempReadBuffer.getNumChannels(),
-                                    static_cast<int>(sample->numChannels));
+            // A span must be contiguous in both the ring and the file, so it
+            // splits at the ring wrap and (when looping) at the loop end
+            int span = std::min(framesToRead - framesDone, ringFrames - writePos);
+            if (looping && loopLength > 0)
+                span = static_cast<int>(std::min<int64_t>(span, loopEnd - fileOffset));
 
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            float* ringBuffer = voice->getWritePointer(ch);
-            const float* sourceData = tempReadBuffer.getReadPointer(ch);
+            float* dest[2] = { voice->getWritePointer(0) + writePos,
+                               sourceChannels > 1 ? voice->getWritePointer(1) + writePos : nullptr };
+
+            success = reader->read(dest, sourceChannels, fileOffset, span);
+
+            // Mono source feeds both ring channels
+            if (success && sourceChannels == 1)
+                juce::FloatVectorOperations::copy(voice->getWritePointer(1) + writePos,
+                                                  voice->getWritePointer(0) + writePos, span);
 
-            for (int frame = 0; frame < framesToRead; ++frame)
+            // Bake the loop-junction crossfade into the streamed data: ring
+            // frames inside the window blend equal-power with the audio
+            // leading into the loop start, so the audio thread renders the
+            // junction with no extra work and no seek ever reaches it
+            if (success && crossfade > 0 && fileOffset + span > loopEnd - crossfade)
             {
-                int ringPos = (writePos + frame) % StreamingConstants::ringBufferFrames;
-                ringBuffer[ringPos] = sourceData[frame];
+                int blendOffset = static_cast<int>(std::max<int64_t>(0, (loopEnd - crossfade) - fileOffset));
+                int blendLength = span - blendOffset;
+                int64_t partnerStart = fileOffset + blendOffset - loopLength;
+
+                blendScratch.setSize(2, blendLength, false, false, true);
+                float* blendDest[2] = { blendScratch.getWritePointer(0),
+                                        sourceChannels > 1 ? blendScratch.getWritePointer(1) : nullptr };
+
+                success = reader->read(blendDest, sourceChannels, partnerStart, blendLength);
+
+                if (success)
+                {
+                    for (int ch = 0; ch < 2; ++ch)
+                    {
+                        float* ring = voice->getWritePointer(ch) + writePos + blendOffset;
+                        const float* partner = blendScratch.getReadPointer(std::min(ch, sourceChannels - 1));
+
+                        for (int i = 0; i < blendLength; ++i)
+                        {
+                            float t = static_cast<float>(fileOffset + blendOffset + i - (loopEnd - crossfade))
+                                      / static_cast<float>(crossfade);
+                            ring[i] = ring[i] * std::cos(t * juce::MathConstants<float>::halfPi)
+                                      + partner[i] * std::sin(t * juce::MathConstants<float>::halfPi);
+                        }
+                    }
+                }
             }
+
+            writePos = (writePos + span) % ringFrames;
+            framesDone += span;
         }
 
-        // Handle mono source -> stereo ring buffer
-        if (numChannels == 1 && sample->numChannels < 2)
+        if (!success)
         {
-            float* ringBuffer = voice->getWritePointer(1);
-            const float* sourceData = tempReadBuffer.getReadPointer(0);
-
-            for (int frame = 0; frame < framesToRead; ++frame)
-            {
-                int ringPos = (writePos + frame) % StreamingConstants::ringBufferFrames;
-                ringBuffer[ringPos] = sourceData[frame];
-            }
+            voice->setReadError(true);
+            break;
         }
 
         // Update positions
@@ -217,19 +545,81 @@ void DiskStreamer::fillVoiceBuffer(int voiceIndex)
         space = voice->spaceAvailable();
     }
 
-    // Check if we reached end of file
-    if (filePos >= totalFrames)
+    // Check if we reached end of file (looping voices stream forever)
+    if (!looping && filePos >= totalFrames)
     {
         voice->setEndOfFile(true);
     }
 
-    streamDebugLog("fillVoiceBuffer[" + juce::String(voiceIndex) + "] EXIT - filled "
-                  + juce::String(totalFramesFilled) + " frames, filePos="
-                  + juce::String(filePos) + "/" + juce::String(totalFrames)
-                  + " EOF=" + juce::String(voice->hasReachedEndOfFile() ? "yes" : "no"));
+    if (totalFramesFilled > 0)
+    {
+        double seconds = juce::Time::highResolutionTicksToSeconds(
+            juce::Time::getHighResolutionTicks() - fillStartTicks);
+
+        if (metrics != nullptr)
+            metrics->recordDiskRead(static_cast<juce::uint32>(seconds * 1.0e6));
+
+        // Only the PCM disk thread profiles the device: the decode worker's
+        // fill times are dominated by codec work, not storage latency
+        if (&worker == static_cast<juce::Thread*>(this)
+            && autoReadPolicy.load(std::memory_order_relaxed))
+            updateDeviceProfile(seconds, totalFramesFilled, chunkFrames);
+    }
+
+    Trace::post(Trace::Event::fillExit, voiceIndex, totalFramesFilled, filePos, totalFrames,
+                voice->hasReachedEndOfFile() ? 1 : 0);
+
+    // Clear the flag only once this voice is safe again; a burst-capped
+    // visit that leaves it below the watermark stays flagged so the
+    // scheduler comes back after the other voices have had their turn
+    if (voice->samplesAvailable() >= StreamingConstants::lowWatermarkFrames
+        || voice->hasReachedEndOfFile() || voice->hasReadError())
+    {
+        voice->clearNeedsData();
+    }
+}
+
+void DiskStreamer::updateDeviceProfile(double fillSeconds, int framesFilled, int chunkFrames)
+{
+    // Average wall time per reader->read call in this fill. Converting a
+    // 4096-frame chunk out of a mapped SSD region takes tens of
+    // microseconds; a spinning disk pays a multi-millisecond seek per call
+    // and a network share adds a round trip on top, so the per-call cost
+    // separates the device classes cleanly regardless of chunk size.
+    int numReads = std::max(1, (framesFilled + chunkFrames - 1) / chunkFrames);
+    double usPerRead = fillSeconds * 1.0e6 / numReads;
+
+    constexpr double slowReadUs = 4000.0;  // latency-bound: seeks/round trips dominate
+    constexpr double fastReadUs = 1000.0;  // comfortably bandwidth-bound
+
+    if (usPerRead >= slowReadUs)
+    {
+        ++slowFillStreak;
+        fastFillStreak = 0;
+    }
+    else if (usPerRead < fastReadUs)
+    {
+        ++fastFillStreak;
+        slowFillStreak = 0;
+    }
+    // In-between readings hold the current streaks: ambiguous evidence
+
+    if (slowFillStreak >= 8 && deviceProfileIndex < 2)
+        ++deviceProfileIndex;
+    else if (fastFillStreak >= 256 && deviceProfileIndex > 0)
+        --deviceProfileIndex;
+    else
+        return;
+
+    slowFillStreak = 0;
+    fastFillStreak = 0;
+
+    auto profile = deviceProfileIndex == 2 ? DiskReadPolicy::network()
+                 : deviceProfileIndex == 1 ? DiskReadPolicy::hardDisk()
+                                           : DiskReadPolicy::solidState();
 
-    // Clear the needs data flag
-    voice->clearNeedsData();
+    readChunkFrames.store(profile.readChunkFrames, std::memory_order_relaxed);
+    maxBurstFrames.store(profile.maxBurstFrames, std::memory_order_relaxed);
 }
 
 std::unique_ptr<juce::AudioFormatReader> DiskStreamer::openReader(const juce::String& filePath)
@@ -241,14 +631,85 @@ std::unique_ptr<juce::AudioFormatReader> DiskStreamer::openReader(const juce::St
     if (!file.existsAsFile())
         return nullptr;
 
+    // Prefer a memory-mapped reader where the format supports it (WAV/AIFF):
+    // read() then converts straight out of the mapped region, and the OS page
+    // cache absorbs repeated round-robin hits on the same files
+    if (auto* format = formatManager->findFormatForFileExtension(file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(
+            format->createMemoryMappedReader(file));
+
+        if (mapped != nullptr && mapped->mapEntireFile())
+            return mapped;
+    }
+
     return std::unique_ptr<juce::AudioFormatReader>(formatManager->createReaderFor(file));
 }
 
+DiskStreamer::SharedReader* DiskStreamer::acquireReader(const juce::String& filePath)
+{
+    auto nowMs = juce::Time::getMillisecondCounter();
+
+    // Cache hit: bump the refcount and hand it out
+    for (auto& entry : readerCache)
+    {
+        if (entry->filePath == filePath)
+        {
+            entry->refCount++;
+            entry->lastUsedMs = nowMs;
+            return entry.get();
+        }
+    }
+
+    // Miss: evict the least recently used unreferenced reader if we're full
+    if (static_cast<int>(readerCache.size()) >= maxCachedReaders)
+    {
+        std::unique_ptr<SharedReader>* lru = nullptr;
+        for (auto& entry : readerCache)
+        {
+            if (entry->refCount == 0
+                && (lru == nullptr || entry->lastUsedMs < (*lru)->lastUsedMs))
+                lru = &entry;
+        }
+
+        if (lru != nullptr)
+            readerCache.erase(readerCache.begin() + (lru - readerCache.data()));
+        // If every reader is referenced we exceed the cap rather than fail
+    }
+
+    auto reader = openReader(filePath);
+    if (reader == nullptr)
+        return nullptr;
+
+    auto shared = std::make_unique<SharedReader>();
+    shared->reader = std::move(reader);
+    shared->filePath = filePath;
+    shared->refCount = 1;
+    shared->lastUsedMs = nowMs;
+
+    readerCache.push_back(std::move(shared));
+    return readerCache.back().get();
+}
+
+void DiskStreamer::releaseReader(SharedReader* shared)
+{
+    if (shared == nullptr)
+        return;
+
+    jassert(shared->refCount > 0);
+    shared->refCount--;
+    shared->lastUsedMs = juce::Time::getMillisecondCounter();
+}
+
 void DiskStreamer::closeReader(int voiceIndex)
 {
     if (voiceIndex >= 0 && voiceIndex < StreamingConstants::maxStreamingVoices)
     {
-        readers[static_cast<size_t>(voiceIndex)].reset();
-        readerFilePaths[static_cast<size_t>(voiceIndex)].clear();
+        auto*& shared = voiceReaders[static_cast<size_t>(voiceIndex)];
+        if (shared != nullptr)
+        {
+            releaseReader(shared);
+            shared = nullptr;
+        }
     }
 }
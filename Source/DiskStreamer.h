@@ -12,10 +12,18 @@
  * DiskStreamer is a background thread that handles all disk I/O for streaming voices.
  *
  * Design:
- * - Polls active voices every few milliseconds
- * - When a voice signals needsData, reads from disk and fills the voice's ring buffer
+ * - Blocks on a lock-free request queue; voices push their index when they
+ *   drop below the low watermark, so the thread sleeps while nothing streams
+ * - When a request arrives, reads from disk and fills the voice's ring buffer
+ * - A long-timeout safety sweep catches any request lost in a race
  * - Manages file readers to avoid repeatedly opening/closing files
  * - Completely non-blocking from audio thread perspective
+ *
+ * Compressed formats (FLAC/Ogg/MP3) are a separate tier: their fills run on
+ * a dedicated lower-priority decode worker with a private, per-voice decoder
+ * kept alive across fills. Each voice's decode position then only ever moves
+ * forward, so the codec never pays a seek-and-resync per chunk, and a slow
+ * decode can never stall the WAV fills on the main disk thread.
  */
 class DiskStreamer : public juce::Thread
 {
@@ -38,30 +46,206 @@ public:
     /** Set the audio format manager for creating file readers */
     void setAudioFormatManager(juce::AudioFormatManager* manager) { formatManager = manager; }
 
+    /** Set the shared health counters (disk read latency histogram) */
+    void setMetrics(StreamingMetrics* m) { metrics = m; }
+
+    /** Pin the read-size policy for the device the library lives on (any
+        thread; each value is read once per fill, so a change mid-stream just
+        takes effect on the next visit). Normally unnecessary - the disk
+        thread profiles the device from its own fill latencies and walks the
+        presets itself - but a caller that knows better can override, which
+        also switches the automatic profiling off. */
+    void setReadPolicy(const DiskReadPolicy& policy)
+    {
+        readChunkFrames.store(policy.readChunkFrames, std::memory_order_relaxed);
+        maxBurstFrames.store(policy.maxBurstFrames, std::memory_order_relaxed);
+        autoReadPolicy.store(false, std::memory_order_relaxed);
+    }
+
+    /** Queue a sample for predictive warming (audio thread, lock-free).
+        The disk thread pre-reads the sample's first post-preload chunk when it
+        has no fill requests pending, so the expected next round-robin hit
+        never pays cold-file first-read latency. The owning published set is
+        retained alongside the pointer, so a request that outlives an
+        instrument switch still dereferences live data. */
+    void requestWarm(const PreloadedSample* sample,
+                     std::shared_ptr<const PreloadedSampleSet> owner);
+
 private:
     void run() override;
 
-    /** Fill a single voice's ring buffer from disk */
-    void fillVoiceBuffer(int voiceIndex);
-
-    /** Open a reader for the given sample file path */
+    /** Main loop of the decode worker: same wake/sweep pattern as run(),
+        restricted to voices streaming compressed formats */
+    void runDecodeWorker();
+
+    /** Fill a single voice's ring buffer from disk (burst-capped per visit) */
+    void fillVoiceBuffer(int voiceIndex, juce::Thread& worker);
+
+    /** Compressed-tier fill: same core as fillVoiceBuffer, but through this
+        voice's private persistent decoder instead of the shared reader cache */
+    void fillCompressedVoice(int voiceIndex, juce::Thread& worker);
+
+    /** The fill core shared by both tiers: streams from the given reader
+        into the voice's ring, handling loop mapping, the baked loop
+        crossfade, EOF and error flags, and the needsData handshake */
+    void fillVoiceFromReader(int voiceIndex, StreamingVoice* voice, const PreloadedSample* sample,
+                             juce::AudioFormatReader* reader, juce::AudioBuffer<float>& blendScratch,
+                             juce::Thread& worker);
+
+    /** Deadline scheduler with seek-aware batching: repeatedly scans every
+        voice's needsData flag, services voices near starvation first in
+        urgency order, then services the rest sorted by (file, offset) so a
+        chord's fills walk each file sequentially instead of seeking between
+        rings in slot order. Loops until all rings in the tier are safe.
+        Runs on the disk thread for the PCM tier and on the decode worker
+        for the compressed tier; each only touches its own voices, and the
+        disk thread wakes the worker when it sees compressed work. */
+    void serviceNeedyVoices(juce::Thread& worker, bool compressedTier);
+
+    /** True for formats whose reads decode (FLAC/Ogg/MP3) rather than copy */
+    static bool isCompressedFile(const juce::String& filePath);
+
+    /** Retunes the active DiskReadPolicy from observed fill latency (PCM
+        disk thread only; compressed fills measure codec time, not storage).
+        A local SSD serves a chunk in well under a millisecond; sustained
+        multi-millisecond reads mean seeks or network round trips dominate,
+        and stepping up to the hardDisk/network presets buys throughput back
+        with fewer, larger reads. */
+    void updateDeviceProfile(double fillSeconds, int framesFilled, int chunkFrames);
+
+    /** Pop the next queued warm request, if any (disk thread). The set
+        reference moves out with the sample, so the caller keeps the sample
+        alive for the duration of the warm. */
+    bool popWarmRequest(const PreloadedSample*& sample,
+                        std::shared_ptr<const PreloadedSampleSet>& owner);
+
+    /** Pre-read a sample's first post-preload chunk into the warm cache */
+    void warmSample(const PreloadedSample* sample);
+
+    // Requests pushed by audio-thread voices, drained by this thread
+    StreamRequestQueue requestQueue;
+
+    // Pending warm requests (audio thread -> disk thread), lock-free SPSC.
+    // Each entry retains the published set its sample lives in, so the
+    // pointer stays valid even if the instrument is switched (and the old
+    // set retired) before the disk thread gets to it. Either side dropping
+    // its reference is just a refcount decrement - the processor's retire
+    // list holds the last one, so destruction never lands on these threads.
+    struct WarmRequest
+    {
+        const PreloadedSample* sample = nullptr;
+        std::shared_ptr<const PreloadedSampleSet> owner;
+    };
+
+    static constexpr int warmQueueCapacity = 64;
+    juce::AbstractFifo warmFifo { warmQueueCapacity };
+    std::array<WarmRequest, warmQueueCapacity> warmSlots;
+
+    // Small LRU cache of pre-read first chunks. Holding the data keeps the
+    // pages hot (and re-warming an already-cached path is a no-op).
+    struct WarmCacheEntry
+    {
+        juce::String filePath;
+        juce::AudioBuffer<float> firstChunk;
+        juce::uint32 lastUsedMs = 0;
+    };
+
+    static constexpr int warmCacheSize = 32;
+    std::array<WarmCacheEntry, warmCacheSize> warmCache;
+
+    /** Open a reader for the given sample file path. Prefers a memory-mapped
+        reader (WAV/AIFF) so conversion happens straight out of the mapped
+        region; falls back to a buffered reader for other formats. */
     std::unique_ptr<juce::AudioFormatReader> openReader(const juce::String& filePath);
 
-    /** Close reader for a voice */
+    /** A refcounted open reader shared between voices hitting the same file.
+        All reader management happens on the disk thread, so no locking. */
+    struct SharedReader
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader;
+        juce::String filePath;
+        int refCount = 0;
+        juce::uint32 lastUsedMs = 0;
+    };
+
+    /** Borrow a reader for a path, opening one only on a cache miss */
+    SharedReader* acquireReader(const juce::String& filePath);
+
+    /** Return a borrowed reader. Unreferenced readers stay open in the cache
+        until LRU eviction, so restrikes of the same file skip the open+parse. */
+    void releaseReader(SharedReader* shared);
+
+    /** Release the reader borrowed by a voice */
     void closeReader(int voiceIndex);
 
     // Array of registered voices (atomic for lock-free access)
     std::array<std::atomic<StreamingVoice*>, StreamingConstants::maxStreamingVoices> voices;
 
-    // File readers - one per voice (managed by disk thread only)
-    std::array<std::unique_ptr<juce::AudioFormatReader>, StreamingConstants::maxStreamingVoices> readers;
+    // Reader cache keyed by path (unique_ptr for pointer stability).
+    // Capacity exceeds the voice count so unreferenced-but-recent readers
+    // survive pedal-down restrike patterns without thrashing.
+    static constexpr int maxCachedReaders = 96;
+    std::vector<std::unique_ptr<SharedReader>> readerCache;
 
-    // Track which sample each reader was opened for
-    std::array<juce::String, StreamingConstants::maxStreamingVoices> readerFilePaths;
-
-    // Temporary buffer for disk reads (to batch reads before writing to ring buffer)
-    juce::AudioBuffer<float> tempReadBuffer;
+    // The reader currently borrowed by each voice slot
+    std::array<SharedReader*, StreamingConstants::maxStreamingVoices> voiceReaders{};
 
     // Audio format manager (owned by processor, we just hold a pointer)
     juce::AudioFormatManager* formatManager = nullptr;
+
+    // Engine-wide health counters (owned by the processor)
+    StreamingMetrics* metrics = nullptr;
+
+    // Read sizing from the active DiskReadPolicy (atomic so the message
+    // thread can retune for the device without stopping the stream)
+    std::atomic<int> readChunkFrames{StreamingConstants::diskReadFrames};
+    std::atomic<int> maxBurstFrames{StreamingConstants::maxFillBurstFrames};
+
+    // Automatic device profiling (streaks are disk-thread only). The
+    // profile index walks the DiskReadPolicy presets: 0 solidState,
+    // 1 hardDisk, 2 network. Escalating needs a short streak of slow
+    // fills; relaxing needs a much longer streak of fast ones, since fast
+    // large reads may just mean the OS cache is warm.
+    std::atomic<bool> autoReadPolicy{true};
+    int deviceProfileIndex = 0;
+    int slowFillStreak = 0;
+    int fastFillStreak = 0;
+
+    // Disk-thread scratch for reading the loop-crossfade partner region
+    // (the audio leading into the loop start) before blending it into a ring
+    juce::AudioBuffer<float> loopBlendBuffer;
+
+    // ==================== Compressed-format decode tier ====================
+
+    // Lower-priority worker that owns every compressed fill, so FLAC decode
+    // time never delays the PCM tier's deadline scheduling
+    struct DecodeWorkerThread : public juce::Thread
+    {
+        explicit DecodeWorkerThread(DiskStreamer& ownerIn)
+            : juce::Thread("SamplerDecode"), owner(ownerIn) {}
+
+        void run() override { owner.runDecodeWorker(); }
+
+        DiskStreamer& owner;
+    };
+
+    DecodeWorkerThread decodeWorker{*this};
+
+    // Wakeups for the decode worker (the disk thread forwards compressed
+    // work it finds during its own sweep)
+    StreamRequestQueue decodeQueue;
+
+    // Persistent per-voice decoder state, owned by the decode worker. Kept
+    // alive across fills so each voice's codec only ever decodes forward -
+    // the one unavoidable backwards seek is the loop wrap, once per cycle.
+    struct DecoderSlot
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader;
+        juce::String filePath;
+    };
+
+    std::array<DecoderSlot, StreamingConstants::maxStreamingVoices> decoderSlots;
+
+    // Decode-worker scratch for the loop-crossfade partner region
+    juce::AudioBuffer<float> decodeBlendBuffer;
 };
@@ -1,14 +1,19 @@
 #pragma once
 
+#include <juce_core/juce_core.h>
 #include <juce_audio_formats/juce_audio_formats.h>
+#include <array>
 #include <atomic>
+#include <memory>
+#include <vector>
+#include "ZoneLookup.h"
 
 /**
  * DFD (Direct From Disk) Streaming Core Types
  *
  * This header defines the fundamental data structures for disk streaming:
  * - PreloadedSample: Sample with only initial data loaded, metadata for streaming
- * - StreamRequest: Communication between audio thread and disk thread
+ * - StreamRequestQueue: Communication between audio thread and disk thread
  */
 
 /**
@@ -31,12 +36,26 @@ struct PreloadedSample
     int highVelocity = 127;
     juce::String name;
 
+    // Release-trigger samples (trigger="release" in the .sss) fire on
+    // note-off instead of note-on: damper noise, harpsichord jack returns.
+    // They get a full-size preload so they play without ever streaming.
+    bool releaseTrigger = false;
+
+    // Loop points in source frames (from .sss attributes or the WAV smpl
+    // chunk); loopEndFrame <= loopStartFrame means no loop
+    int64_t loopStartFrame = 0;
+    int64_t loopEndFrame = 0;
+
     // Preload configuration
-    static constexpr int preloadSizeBytes = 65536;  // 64KB preload
+    static constexpr int preloadSizeBytes = 65536;  // Default preload (see PreloadPolicy)
+    int preloadBytes = preloadSizeBytes;             // Actual preload budget for this sample
     int preloadSizeFrames = 0;                       // Calculated based on channels/bit depth
 
     bool isValid() const { return totalSampleFrames > 0 && filePath.isNotEmpty(); }
 
+    /** True when a sustain loop is defined */
+    bool hasLoop() const { return loopEndFrame > loopStartFrame; }
+
     /** Returns true if this sample is large enough to require streaming */
     bool needsStreaming() const { return totalSampleFrames > preloadSizeFrames; }
 
@@ -60,24 +79,53 @@ struct PreloadedSample
 };
 
 /**
- * StreamRequest is used to communicate between the audio thread and disk thread.
- * The audio thread sets these atomically, and the disk thread polls them.
+ * PreloadedSampleSet is an immutable snapshot of a streaming instrument:
+ * the preloaded samples plus the note-on resolution index built over them.
+ *
+ * Sets are built off to the side, published with one atomic shared_ptr swap
+ * and never mutated afterwards (RCU). Voices retain a reference to the set
+ * they started on, so an instrument switch mid-note never invalidates the
+ * sample a playing voice points into; the old set is reclaimed once the
+ * last voice referencing it has ended.
+ *
+ * enable_shared_from_this lets the audio thread turn its raw published
+ * pointer back into an owning reference without touching the shared_ptr
+ * atomics (which are not lock-free); sets must always be created with
+ * std::make_shared.
  */
-struct StreamRequest
+struct PreloadedSampleSet : public std::enable_shared_from_this<PreloadedSampleSet>
 {
-    std::atomic<bool> active{false};           // Is this voice currently streaming?
-    std::atomic<int64_t> filePosition{0};      // Current position in source file (frames)
-    std::atomic<bool> needsData{false};        // Signal from audio thread to disk thread
-    std::atomic<bool> endOfFile{false};        // Disk thread signals EOF reached
-    std::atomic<bool> readError{false};        // Disk thread signals read error
+    std::vector<PreloadedSample> samples;
+    ZoneLookup lookup;         // note-on samples
+    ZoneLookup releaseLookup;  // release-trigger samples, matched on note-off
+};
 
-    void reset()
+/**
+ * PreloadPolicy turns the old fixed 64KB preload into a runtime decision:
+ * a global RAM budget, an optional per-instrument base size (from the
+ * <preload> element in instrument.sss), and a per-sample weighting that
+ * gives low notes and sustain-length material more underrun headroom while
+ * one-shots are naturally capped at their file length.
+ */
+struct PreloadPolicy
+{
+    static constexpr int64_t defaultRamBudgetBytes = 256LL * 1024 * 1024;
+    static constexpr int minPreloadBytes = 16384;           // floor per streaming sample
+    static constexpr int maxPreloadBytes = 1024 * 1024;     // cap per streaming sample
+
+    // Total preload RAM allowed across the instrument
+    int64_t ramBudgetBytes = defaultRamBudgetBytes;
+
+    // Base preload per sample before weighting (per-instrument override)
+    int basePreloadBytes = PreloadedSample::preloadSizeBytes;
+
+    /** Weighted preload size for one sample, before budget scaling.
+        Low notes decay longer and stream sooner, so they get up to 2x. */
+    int weightedPreloadBytes(int rootNote) const
     {
-        active.store(false, std::memory_order_release);
-        filePosition.store(0, std::memory_order_release);
-        needsData.store(false, std::memory_order_release);
-        endOfFile.store(false, std::memory_order_release);
-        readError.store(false, std::memory_order_release);
+        double weight = 1.0 + juce::jlimit(0, 60, 60 - rootNote) / 60.0;
+        auto bytes = static_cast<int>(basePreloadBytes * weight);
+        return juce::jlimit(minPreloadBytes, maxPreloadBytes, bytes);
     }
 };
 
@@ -95,12 +143,164 @@ namespace StreamingConstants
     // Batch read size for disk operations
     constexpr int diskReadFrames = 4096;  // ~93ms at 44.1kHz
 
+    // Per-visit read cap for one voice. The disk thread services voices in
+    // urgency order; this stops one empty ring from monopolising the thread
+    // while other voices drain toward their own deadlines.
+    constexpr int maxFillBurstFrames = diskReadFrames * 2;
+
     // Maximum number of streaming voices
     constexpr int maxStreamingVoices = 64;
 
-    // Disk thread polling interval in milliseconds
-    constexpr int diskThreadPollMs = 5;
+    // Separate pool of lightweight in-RAM voices for samples that fit
+    // entirely in their preload (no ring buffer, no disk registration)
+    constexpr int maxPreloadVoices = 64;
+
+    // Safety-net timeout for the disk thread's blocking wait, in milliseconds.
+    // The thread normally wakes on queued requests; this only bounds how long
+    // a lost wakeup could go unnoticed.
+    constexpr int diskThreadIdleTimeoutMs = 500;
 
     // Fade out duration in samples for underrun protection
     constexpr int underrunFadeOutSamples = 64;
+
+    // Equal-power crossfade across a sustain-loop junction (~23ms at 44.1kHz).
+    // Clamped to the material: never longer than the loop itself or the
+    // audio available before the loop start.
+    constexpr int loopCrossfadeFrames = 1024;
 }
+
+/**
+ * DiskReadPolicy sizes the disk thread's reads for the device the library
+ * lives on. The diskReadFrames/maxFillBurstFrames constants above are the
+ * local-SSD defaults; seek-bound spinning disks and high-latency network
+ * shares both want fewer, larger reads so throughput is bound by bandwidth
+ * rather than by seeks or IOPS.
+ */
+struct DiskReadPolicy
+{
+    int readChunkFrames = StreamingConstants::diskReadFrames;     // per reader->read call
+    int maxBurstFrames = StreamingConstants::maxFillBurstFrames;  // per-voice cap per scheduler visit
+
+    static DiskReadPolicy solidState() { return {}; }
+    static DiskReadPolicy hardDisk()
+    {
+        return { StreamingConstants::diskReadFrames * 4,
+                 StreamingConstants::maxFillBurstFrames * 2 };
+    }
+    static DiskReadPolicy network()
+    {
+        return { StreamingConstants::diskReadFrames * 8,
+                 StreamingConstants::maxFillBurstFrames * 4 };
+    }
+};
+
+/**
+ * StreamRequestQueue is a lock-free MPSC queue of voice indices from the
+ * rendering threads to the disk thread, replacing the old needsData polling.
+ *
+ * A producer pushes a voice index when that voice first drops below the low
+ * watermark; the disk thread blocks on the wake event and services indices as
+ * they arrive, so idle periods cost zero wakeups and a starving voice is
+ * serviced at scheduler-wake latency instead of the next poll tick.
+ *
+ * Multi-producer matters here: the render pool's workers and the audio thread
+ * all render voices concurrently, so pushes can race. Cells carry a sequence
+ * number and the enqueue position is claimed by CAS (Vyukov-style, same ring
+ * as the trace buffer); the disk thread is the only consumer.
+ */
+class StreamRequestQueue
+{
+public:
+    StreamRequestQueue()
+    {
+        for (juce::uint32 i = 0; i < queueCapacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /** Push a voice index (audio thread or a render worker). If the queue is
+        somehow full the index is dropped but the disk thread is still woken -
+        its safety sweep will find the voice via its needsData flag. */
+    void push(int voiceIndex)
+    {
+        juce::uint32 pos = enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell& cell = cells[pos & queueMask];
+            juce::uint32 seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<juce::int32>(seq - pos);
+
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.voiceIndex = voiceIndex;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                break;  // full: drop rather than block a realtime thread
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        wakeEvent.signal();
+    }
+
+    /** Pop the next voice index (disk thread). Returns false when empty. */
+    bool pop(int& voiceIndex)
+    {
+        Cell& cell = cells[dequeuePos & queueMask];
+        juce::uint32 seq = cell.sequence.load(std::memory_order_acquire);
+
+        if (static_cast<juce::int32>(seq - (dequeuePos + 1)) != 0)
+            return false;  // nothing filled yet
+
+        voiceIndex = cell.voiceIndex;
+        cell.sequence.store(dequeuePos + queueCapacity, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    /** Block until a request arrives or the timeout expires (disk thread).
+        Returns true if a request is ready. */
+    bool waitForRequest(int timeoutMs)
+    {
+        if (hasRequestReady())
+            return true;
+
+        return wakeEvent.wait(timeoutMs) && hasRequestReady();
+    }
+
+    /** Wake the disk thread without queuing anything (used for shutdown). */
+    void wake() { wakeEvent.signal(); }
+
+private:
+    static constexpr juce::uint32 queueCapacity = StreamingConstants::maxStreamingVoices * 2;
+    static constexpr juce::uint32 queueMask = queueCapacity - 1;
+    static_assert((queueCapacity & queueMask) == 0, "sequence wrap relies on a power-of-two size");
+
+    struct Cell
+    {
+        std::atomic<juce::uint32> sequence{0};
+        int voiceIndex = -1;
+    };
+
+    /** True when the cell at the dequeue position has been filled (disk thread). */
+    bool hasRequestReady() const
+    {
+        juce::uint32 seq = cells[dequeuePos & queueMask].sequence.load(std::memory_order_acquire);
+        return static_cast<juce::int32>(seq - (dequeuePos + 1)) == 0;
+    }
+
+    std::array<Cell, queueCapacity> cells;
+    std::atomic<juce::uint32> enqueuePos{0};
+    juce::uint32 dequeuePos = 0;  // consumer only
+
+    juce::WaitableEvent wakeEvent;
+};
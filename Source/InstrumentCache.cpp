@@ -0,0 +1,175 @@
+#include "InstrumentCache.h"
+
+juce::File InstrumentCache::getCacheFileFor(const juce::File& definitionFile)
+{
+    return definitionFile.getSiblingFile("instrument.sssc");
+}
+
+bool InstrumentCache::load(const juce::File& definitionFile, const PreloadPolicy& policy,
+                           juce::String& name, juce::String& author,
+                           std::vector<PreloadedSample>& samples)
+{
+    auto cacheFile = getCacheFileFor(definitionFile);
+    if (!cacheFile.existsAsFile())
+        return false;
+
+    juce::FileInputStream in(cacheFile);
+    if (!in.openedOk())
+        return false;
+
+    // Header: magic, version, source mtime
+    if (in.readInt() != cacheMagic)
+        return false;
+
+    if (in.readInt() != cacheVersion)
+        return false;
+
+    if (in.readInt64() != definitionFile.getLastModificationTime().toMilliseconds())
+        return false;
+
+    // A different RAM budget means the baked preload sizes no longer apply
+    if (in.readInt64() != policy.ramBudgetBytes)
+        return false;
+
+    auto loadedName = in.readString();
+    auto loadedAuthor = in.readString();
+
+    int numSamples = in.readInt();
+    if (numSamples < 0)
+        return false;
+
+    auto folder = definitionFile.getParentDirectory();
+    std::vector<PreloadedSample> loadedSamples;
+    loadedSamples.reserve(static_cast<size_t>(numSamples));
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        PreloadedSample sample;
+
+        auto relativePath = in.readString();
+        auto sourceMtime = in.readInt64();
+
+        auto sampleFile = folder.getChildFile(relativePath);
+        sample.filePath = sampleFile.getFullPathName();
+        sample.name = sampleFile.getFileNameWithoutExtension();
+
+        // A moved or re-rendered sample invalidates the whole cache
+        // (getLastModificationTime is a stat, far cheaper than opening the WAV)
+        if (!sampleFile.existsAsFile()
+            || sampleFile.getLastModificationTime().toMilliseconds() != sourceMtime)
+            return false;
+
+        sample.rootNote = in.readInt();
+        sample.lowNote = in.readInt();
+        sample.highNote = in.readInt();
+        sample.lowVelocity = in.readInt();
+        sample.highVelocity = in.readInt();
+        sample.releaseTrigger = in.readBool();
+
+        sample.sampleRate = in.readDouble();
+        sample.numChannels = in.readInt();
+        sample.totalSampleFrames = in.readInt64();
+        sample.loopStartFrame = in.readInt64();
+        sample.loopEndFrame = in.readInt64();
+        sample.preloadBytes = in.readInt();
+        sample.preloadSizeFrames = in.readInt();
+
+        int preloadChannels = in.readInt();
+        int preloadFrames = in.readInt();
+
+        // Bound the allocation before trusting it: a corrupt or truncated
+        // sidecar must fail the load here, not drive setSize into a
+        // multi-gigabyte buffer. No legitimate preload exceeds the
+        // per-sample cap it was compiled under.
+        auto preloadByteSize = static_cast<int64_t>(preloadFrames) * preloadChannels
+                               * static_cast<int64_t>(sizeof(float));
+
+        if (preloadChannels <= 0 || preloadChannels > 16 || preloadFrames < 0
+            || preloadByteSize > PreloadPolicy::maxPreloadBytes
+            || preloadByteSize > in.getNumBytesRemaining())
+            return false;
+
+        sample.preloadBuffer.setSize(preloadChannels, preloadFrames);
+
+        for (int ch = 0; ch < preloadChannels; ++ch)
+        {
+            auto bytesToRead = static_cast<size_t>(preloadFrames) * sizeof(float);
+            if (in.read(sample.preloadBuffer.getWritePointer(ch),
+                        static_cast<int>(bytesToRead)) != static_cast<int>(bytesToRead))
+                return false;
+        }
+
+        loadedSamples.push_back(std::move(sample));
+    }
+
+    name = loadedName;
+    author = loadedAuthor;
+    samples = std::move(loadedSamples);
+    return true;
+}
+
+bool InstrumentCache::save(const juce::File& definitionFile, const PreloadPolicy& policy,
+                           const juce::String& name, const juce::String& author,
+                           const std::vector<PreloadedSample>& samples)
+{
+    auto cacheFile = getCacheFileFor(definitionFile);
+    auto folder = definitionFile.getParentDirectory();
+
+    // Write to a temp file and swap in so a crashed write never leaves
+    // a truncated sidecar behind
+    juce::TemporaryFile tempFile(cacheFile);
+
+    {
+        juce::FileOutputStream out(tempFile.getFile());
+        if (!out.openedOk())
+            return false;
+
+        out.writeInt(cacheMagic);
+        out.writeInt(cacheVersion);
+        out.writeInt64(definitionFile.getLastModificationTime().toMilliseconds());
+        out.writeInt64(policy.ramBudgetBytes);
+
+        out.writeString(name);
+        out.writeString(author);
+
+        out.writeInt(static_cast<int>(samples.size()));
+
+        for (const auto& sample : samples)
+        {
+            juce::File sampleFile(sample.filePath);
+
+            out.writeString(sampleFile.getRelativePathFrom(folder));
+            out.writeInt64(sampleFile.getLastModificationTime().toMilliseconds());
+
+            out.writeInt(sample.rootNote);
+            out.writeInt(sample.lowNote);
+            out.writeInt(sample.highNote);
+            out.writeInt(sample.lowVelocity);
+            out.writeInt(sample.highVelocity);
+            out.writeBool(sample.releaseTrigger);
+
+            out.writeDouble(sample.sampleRate);
+            out.writeInt(sample.numChannels);
+            out.writeInt64(sample.totalSampleFrames);
+            out.writeInt64(sample.loopStartFrame);
+            out.writeInt64(sample.loopEndFrame);
+            out.writeInt(sample.preloadBytes);
+            out.writeInt(sample.preloadSizeFrames);
+
+            int preloadChannels = sample.preloadBuffer.getNumChannels();
+            int preloadFrames = sample.preloadBuffer.getNumSamples();
+            out.writeInt(preloadChannels);
+            out.writeInt(preloadFrames);
+
+            for (int ch = 0; ch < preloadChannels; ++ch)
+            {
+                out.write(sample.preloadBuffer.getReadPointer(ch),
+                          static_cast<size_t>(preloadFrames) * sizeof(float));
+            }
+        }
+
+        out.flush();
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
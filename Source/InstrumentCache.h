@@ -0,0 +1,42 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+#include "DiskStreaming.h"
+
+/**
+ * InstrumentCache reads and writes a compiled binary sidecar (instrument.sssc)
+ * next to instrument.sss.
+ *
+ * The sidecar stores everything a streaming load normally recovers by parsing
+ * the XML and opening every WAV (zone mappings, sampleRate, lengthInSamples,
+ * channel count) plus the preload audio itself, as one flat little-endian blob
+ * that loads with a single sequential read.
+ *
+ * The cache is invalidated when instrument.sss or any referenced sample file
+ * has a different modification time than the one recorded at write time.
+ */
+class InstrumentCache
+{
+public:
+    /** Returns the sidecar file for a given instrument definition file. */
+    static juce::File getCacheFileFor(const juce::File& definitionFile);
+
+    /** Attempts to load the instrument from its sidecar.
+        Returns false (leaving outputs untouched) if the sidecar is missing,
+        from an older format version, stale relative to the source files, or
+        compiled under a different preload policy. */
+    static bool load(const juce::File& definitionFile, const PreloadPolicy& policy,
+                     juce::String& name, juce::String& author,
+                     std::vector<PreloadedSample>& samples);
+
+    /** Writes (or rewrites) the sidecar after a successful XML load. */
+    static bool save(const juce::File& definitionFile, const PreloadPolicy& policy,
+                     const juce::String& name, const juce::String& author,
+                     const std::vector<PreloadedSample>& samples);
+
+private:
+    // 'SSSC' little-endian
+    static constexpr int cacheMagic = 0x43535353;
+    static constexpr int cacheVersion = 4;  // v4: release-trigger flag
+};
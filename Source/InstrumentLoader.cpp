@@ -21,6 +21,50 @@ void InstrumentLoader::ensureInstrumentsFolderExists()
     }
 }
 
+juce::File InstrumentLoader::getScanCacheFile()
+{
+    return getInstrumentsFolder().getSiblingFile("instruments.scancache");
+}
+
+std::map<juce::String, InstrumentLoader::ScanCacheEntry> InstrumentLoader::readScanCache()
+{
+    std::map<juce::String, ScanCacheEntry> cache;
+
+    auto xml = juce::XmlDocument::parse(getScanCacheFile());
+    if (xml == nullptr || !xml->hasTagName("scanCache"))
+        return cache;
+
+    for (auto* elem : xml->getChildIterator())
+    {
+        if (!elem->hasTagName("instrument"))
+            continue;
+
+        ScanCacheEntry entry;
+        entry.modificationTime = elem->getStringAttribute("mtime").getLargeIntValue();
+        entry.name = elem->getStringAttribute("name");
+        entry.author = elem->getStringAttribute("author");
+        cache[elem->getStringAttribute("path")] = entry;
+    }
+
+    return cache;
+}
+
+void InstrumentLoader::writeScanCache(const std::map<juce::String, ScanCacheEntry>& cache)
+{
+    juce::XmlElement root("scanCache");
+
+    for (const auto& [path, entry] : cache)
+    {
+        auto* elem = root.createNewChildElement("instrument");
+        elem->setAttribute("path", path);
+        elem->setAttribute("mtime", juce::String(entry.modificationTime));
+        elem->setAttribute("name", entry.name);
+        elem->setAttribute("author", entry.author);
+    }
+
+    root.writeTo(getScanCacheFile());
+}
+
 std::vector<InstrumentInfo> InstrumentLoader::scanForInstruments()
 {
     std::vector<InstrumentInfo> instruments;
@@ -29,6 +73,10 @@ std::vector<InstrumentInfo> InstrumentLoader::scanForInstruments()
     if (!instrumentsFolder.exists())
         return instruments;
 
+    auto cache = readScanCache();
+    std::map<juce::String, ScanCacheEntry> freshCache;
+    bool cacheDirty = false;
+
     // Scan for folders containing instrument.sss
     for (const auto& entry : juce::RangedDirectoryIterator(instrumentsFolder, false, "*", juce::File::findDirectories))
     {
@@ -42,25 +90,51 @@ std::vector<InstrumentInfo> InstrumentLoader::scanForInstruments()
             info.definitionFile = definitionFile;
             info.name = folder.getFileNameWithoutExtension(); // Default to folder name
 
-            // Try to parse XML to get actual name and author
-            if (auto xml = juce::XmlDocument::parse(definitionFile))
+            auto path = definitionFile.getFullPathName();
+            auto modificationTime = definitionFile.getLastModificationTime().toMilliseconds();
+            auto cached = cache.find(path);
+
+            if (cached != cache.end() && cached->second.modificationTime == modificationTime)
             {
-                if (xml->hasTagName("SuperSimpleSampler"))
+                // Unchanged since the last scan - skip the XML parse
+                if (cached->second.name.isNotEmpty())
+                    info.name = cached->second.name;
+                info.author = cached->second.author;
+            }
+            else
+            {
+                // New or changed: parse just the meta block
+                if (auto xml = juce::XmlDocument::parse(definitionFile))
                 {
-                    if (auto* meta = xml->getChildByName("meta"))
+                    if (xml->hasTagName("SuperSimpleSampler"))
                     {
-                        if (auto* nameElem = meta->getChildByName("name"))
-                            info.name = nameElem->getAllSubText().trim();
-                        if (auto* authorElem = meta->getChildByName("author"))
-                            info.author = authorElem->getAllSubText().trim();
+                        if (auto* meta = xml->getChildByName("meta"))
+                        {
+                            if (auto* nameElem = meta->getChildByName("name"))
+                                info.name = nameElem->getAllSubText().trim();
+                            if (auto* authorElem = meta->getChildByName("author"))
+                                info.author = authorElem->getAllSubText().trim();
+                        }
                     }
                 }
+
+                cacheDirty = true;
             }
 
+            ScanCacheEntry fresh;
+            fresh.modificationTime = modificationTime;
+            fresh.name = info.name;
+            fresh.author = info.author;
+            freshCache[path] = fresh;
+
             instruments.push_back(info);
         }
     }
 
+    // Removed instruments also invalidate the cache
+    if (cacheDirty || freshCache.size() != cache.size())
+        writeScanCache(freshCache);
+
     // Sort by name
     std::sort(instruments.begin(), instruments.end(),
               [](const InstrumentInfo& a, const InstrumentInfo& b) {
@@ -130,6 +204,18 @@ bool InstrumentLoader::parseInstrumentXML(const juce::File& xmlFile, InstrumentI
                 zone.highNote = sampleElem->getIntAttribute("hiNote", 127);
                 zone.lowVelocity = sampleElem->getIntAttribute("loVel", 1);
                 zone.highVelocity = sampleElem->getIntAttribute("hiVel", 127);
+                zone.releaseTrigger = sampleElem->getStringAttribute("trigger") == "release";
+
+                // Explicit loop attributes override whatever loadSampleFile
+                // picked up from the WAV smpl chunk
+                if (sampleElem->hasAttribute("loopStart") || sampleElem->hasAttribute("loopEnd"))
+                {
+                    zone.loopStart = sampleElem->getIntAttribute("loopStart", 0);
+                    zone.loopEnd = sampleElem->getIntAttribute("loopEnd", 0);
+                }
+
+                zone.loopStart = juce::jlimit(0, zone.audioData.getNumSamples(), zone.loopStart);
+                zone.loopEnd = juce::jlimit(0, zone.audioData.getNumSamples(), zone.loopEnd);
 
                 zones.push_back(std::move(zone));
             }
@@ -153,5 +239,12 @@ bool InstrumentLoader::loadSampleFile(const juce::File& sampleFile, SampleZone&
                            static_cast<int>(reader->lengthInSamples));
     reader->read(&zone.audioData, 0, static_cast<int>(reader->lengthInSamples), 0, true, true);
 
+    // Pick up a sustain loop from the WAV smpl chunk when present
+    if (reader->metadataValues.getValue("NumSampleLoops", "0").getIntValue() > 0)
+    {
+        zone.loopStart = reader->metadataValues.getValue("Loop0Start", "0").getIntValue();
+        zone.loopEnd = reader->metadataValues.getValue("Loop0End", "0").getIntValue();
+    }
+
     return zone.audioData.getNumSamples() > 0;
 }
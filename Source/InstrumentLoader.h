@@ -2,6 +2,7 @@
 
 #include <juce_core/juce_core.h>
 #include <juce_audio_formats/juce_audio_formats.h>
+#include <map>
 #include "SampleZone.h"
 
 struct InstrumentInfo
@@ -33,7 +34,9 @@ public:
     // Create the instruments folder if it doesn't exist
     static void ensureInstrumentsFolderExists();
 
-    // Scan for available instruments
+    // Scan for available instruments. Incremental: name/author come from a
+    // persisted cache keyed on definition-file mtime, so only new or changed
+    // instruments pay an XML parse.
     std::vector<InstrumentInfo> scanForInstruments();
 
     // Load an instrument from its definition file
@@ -47,4 +50,17 @@ private:
 
     bool parseInstrumentXML(const juce::File& xmlFile, InstrumentInfo& info, std::vector<SampleZone>& zones);
     bool loadSampleFile(const juce::File& sampleFile, SampleZone& zone);
+
+    // Scan cache: definition-file path -> (mtime, name, author), persisted
+    // next to the Instruments folder so repeated scans skip unchanged files
+    struct ScanCacheEntry
+    {
+        juce::int64 modificationTime = 0;
+        juce::String name;
+        juce::String author;
+    };
+
+    static juce::File getScanCacheFile();
+    static std::map<juce::String, ScanCacheEntry> readScanCache();
+    static void writeScanCache(const std::map<juce::String, ScanCacheEntry>& cache);
 };
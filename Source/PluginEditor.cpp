@@ -126,7 +126,12 @@ void InstrumentListBox::listBoxItemDoubleClicked(int row, const juce::MouseEvent
 
 void InstrumentListBox::refresh()
 {
-    processor.refreshInstrumentList();
+    processor.refreshInstrumentList();  // async; instrumentListChanged fires on completion
+    updateFromProcessor();
+}
+
+void InstrumentListBox::updateFromProcessor()
+{
     instruments = processor.getAvailableInstruments();
     listBox.updateContent();
 }
@@ -279,6 +284,19 @@ SuperSimpleSamplerEditor::SuperSimpleSamplerEditor(SuperSimpleSamplerProcessor&
     polyphonyAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         processorRef.getParameters(), "polyphony", polyphonySlider);
 
+    // Resampling quality selector (items come from the choice parameter)
+    qualityLabel.setText("Quality", juce::dontSendNotification);
+    qualityLabel.setFont(juce::FontOptions(12.0f));
+    addAndMakeVisible(qualityLabel);
+
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(
+            processorRef.getParameters().getParameter("quality")))
+        qualityBox.addItemList(choice->choices, 1);
+
+    addAndMakeVisible(qualityBox);
+    qualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        processorRef.getParameters(), "quality", qualityBox);
+
     // Initial state
     updateInstrumentInfo();
     updateWaveformDisplay();
@@ -295,6 +313,19 @@ SuperSimpleSamplerEditor::~SuperSimpleSamplerEditor()
 
 void SuperSimpleSamplerEditor::timerCallback()
 {
+    // A session restore is still loading on the background loader thread
+    if (!processorRef.isInstrumentReady())
+    {
+        juce::String loading = "Restoring instrument...";
+        int total = processorRef.getPreloadTotal();
+        if (total > 0)
+            loading += " (" + juce::String(processorRef.getPreloadProgress())
+                       + "/" + juce::String(total) + ")";
+
+        instrumentAuthorLabel.setText(loading, juce::dontSendNotification);
+        return;
+    }
+
     // Update the author label with last played info for debugging
     auto lastPlayed = processorRef.getLastPlayedSample();
     if (lastPlayed.isNotEmpty() && processorRef.hasInstrumentLoaded())
@@ -302,6 +333,16 @@ void SuperSimpleSamplerEditor::timerCallback()
         const auto& instrument = processorRef.getCurrentInstrument();
         juce::String info = "by " + instrument.info.author;
         info += " (" + juce::String(instrument.zones.size()) + " samples) - " + lastPlayed;
+
+        // Streaming health at a glance; the full report is exportable
+        if (processorRef.isStreamingEnabled())
+        {
+            auto metrics = processorRef.getStreamingMetricsSnapshot();
+            info += " | voices " + juce::String(metrics.activeVoices);
+            if (metrics.underruns > 0)
+                info += " | underruns " + juce::String(metrics.underruns);
+        }
+
         instrumentAuthorLabel.setText(info, juce::dontSendNotification);
     }
 }
@@ -363,6 +404,12 @@ void SuperSimpleSamplerEditor::resized()
     waveformDisplay.setBounds(rightPanel.removeFromTop(70));
     rightPanel.removeFromTop(6);
 
+    // Resampling quality selector under the knobs
+    auto qualityRow = rightPanel.removeFromBottom(22);
+    qualityLabel.setBounds(qualityRow.removeFromLeft(50));
+    qualityBox.setBounds(qualityRow.removeFromLeft(180));
+    rightPanel.removeFromBottom(4);
+
     // Knobs - 6 columns
     auto knobArea = rightPanel;
     const int knobWidth = knobArea.getWidth() / 6;
@@ -393,6 +440,12 @@ void SuperSimpleSamplerEditor::resized()
     polyphonySlider.setBounds(polyphonyArea);
 }
 
+void SuperSimpleSamplerEditor::instrumentListChanged()
+{
+    // Already on the message thread (scan results arrive via callAsync)
+    instrumentList.updateFromProcessor();
+}
+
 void SuperSimpleSamplerEditor::instrumentChanged()
 {
     juce::MessageManager::callAsync([this]()
@@ -403,6 +456,15 @@ void SuperSimpleSamplerEditor::instrumentChanged()
     });
 }
 
+void SuperSimpleSamplerEditor::instrumentAboutToChange()
+{
+    // The zones behind these views are about to be destroyed; let go of the
+    // waveform display's raw zone pointer and empty the sample list now so
+    // no repaint can dereference them before instrumentChanged arrives
+    waveformDisplay.setZone(nullptr);
+    sampleList.refresh();
+}
+
 void SuperSimpleSamplerEditor::updateInstrumentInfo()
 {
     if (processorRef.hasInstrumentLoaded())
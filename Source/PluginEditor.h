@@ -26,8 +26,12 @@ public:
     void listBoxItemClicked(int row, const juce::MouseEvent&) override;
     void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override;
 
+    // Starts a background rescan; the list repopulates when it completes
     void refresh();
 
+    // Pulls the processor's current list without triggering a rescan
+    void updateFromProcessor();
+
 private:
     SuperSimpleSamplerProcessor& processor;
     juce::ListBox listBox;
@@ -69,6 +73,8 @@ public:
 
     // Processor listener
     void instrumentChanged() override;
+    void instrumentAboutToChange() override;
+    void instrumentListChanged() override;
 
 private:
     SuperSimpleSamplerProcessor& processorRef;
@@ -91,6 +97,9 @@ private:
     juce::Slider gainSlider;
     juce::Slider polyphonySlider;
 
+    juce::ComboBox qualityBox;
+    juce::Label qualityLabel;
+
     juce::Label attackLabel;
     juce::Label decayLabel;
     juce::Label sustainLabel;
@@ -104,6 +113,7 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> releaseAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> polyphonyAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> qualityAttachment;
 
     void updateInstrumentInfo();
     void updateWaveformDisplay();
@@ -1,8 +1,15 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include <algorithm>
 #include <fstream>
-
-// Debug logging to file
+#include <limits>
+#include <thread>
+#include "InstrumentCache.h"
+#include "Resampler.h"
+#include "Trace.h"
+
+// Debug logging to file. Load-time / message-thread use only - anything on
+// the audio or disk path goes through Trace instead.
 static void debugLog(const juce::String& msg)
 {
     auto logFile = juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getChildFile("sampler_debug.txt");
@@ -69,6 +76,13 @@ static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout
         1, 64, 16
     ));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("quality", 1),
+        "Quality",
+        juce::StringArray { "Live (Linear)", "Standard (Catmull-Rom)", "High (Sinc)" },
+        1
+    ));
+
     return { params.begin(), params.end() };
 }
 
@@ -80,9 +94,14 @@ SuperSimpleSamplerProcessor::SuperSimpleSamplerProcessor()
     // Ensure instruments folder exists
     InstrumentLoader::ensureInstrumentsFolderExists();
 
-    // Add max voices to the sampler (actual polyphony controlled by parameter)
+    // Add max voices to the sampler (actual polyphony controlled by parameter),
+    // keeping a typed array alongside so hot paths skip the dynamic_cast
     for (int i = 0; i < 64; ++i)
-        sampler.addVoice(new SampleZoneVoice());
+    {
+        auto* voice = new SampleZoneVoice();
+        samplerVoices.push_back(voice);
+        sampler.addVoice(voice);
+    }
 
     attackParam = parameters.getRawParameterValue("attack");
     decayParam = parameters.getRawParameterValue("decay");
@@ -90,6 +109,14 @@ SuperSimpleSamplerProcessor::SuperSimpleSamplerProcessor()
     releaseParam = parameters.getRawParameterValue("release");
     gainParam = parameters.getRawParameterValue("gain");
     polyphonyParam = parameters.getRawParameterValue("polyphony");
+    qualityParam = parameters.getRawParameterValue("quality");
+
+    // Envelope changes bump an epoch; the audio thread re-applies them
+    // only when the epoch is stale
+    parameters.addParameterListener("attack", this);
+    parameters.addParameterListener("decay", this);
+    parameters.addParameterListener("sustain", this);
+    parameters.addParameterListener("release", this);
 
     // Initialize streaming components
     streamingFormatManager.registerBasicFormats();
@@ -100,14 +127,28 @@ SuperSimpleSamplerProcessor::SuperSimpleSamplerProcessor()
     for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
     {
         diskStreamer->registerVoice(i, &streamingVoices[static_cast<size_t>(i)]);
+        streamingVoices[static_cast<size_t>(i)].setMetrics(&streamingMetrics);
     }
 
+    diskStreamer->setMetrics(&streamingMetrics);
+
     // Initial scan for instruments
     refreshInstrumentList();
 }
 
 SuperSimpleSamplerProcessor::~SuperSimpleSamplerProcessor()
 {
+    parameters.removeParameterListener("attack", this);
+    parameters.removeParameterListener("decay", this);
+    parameters.removeParameterListener("sustain", this);
+    parameters.removeParameterListener("release", this);
+
+    if (instrumentScanThread.joinable())
+        instrumentScanThread.join();
+
+    if (stateRestoreThread.joinable())
+        stateRestoreThread.join();
+
     // Stop the disk streaming thread before destruction
     if (diskStreamer != nullptr)
     {
@@ -115,6 +156,12 @@ SuperSimpleSamplerProcessor::~SuperSimpleSamplerProcessor()
     }
 }
 
+void SuperSimpleSamplerProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+    adsrParamEpoch.fetch_add(1, std::memory_order_release);
+}
+
 const juce::String SuperSimpleSamplerProcessor::getName() const
 {
     return JucePlugin_Name;
@@ -135,12 +182,9 @@ void SuperSimpleSamplerProcessor::prepareToPlay(double sampleRate, int samplesPe
 {
     sampler.setCurrentPlaybackSampleRate(sampleRate);
 
-    for (int i = 0; i < sampler.getNumVoices(); ++i)
+    for (auto* voice : samplerVoices)
     {
-        if (auto* voice = dynamic_cast<SampleZoneVoice*>(sampler.getVoice(i)))
-        {
-            voice->prepareToPlay(sampleRate, samplesPerBlock);
-        }
+        voice->prepareToPlay(sampleRate, samplesPerBlock);
     }
 
     // Prepare streaming voices
@@ -149,17 +193,37 @@ void SuperSimpleSamplerProcessor::prepareToPlay(double sampleRate, int samplesPe
         voice.prepareToPlay(sampleRate, samplesPerBlock);
     }
 
+    for (auto& voice : preloadVoices)
+    {
+        voice.prepareToPlay(sampleRate, samplesPerBlock);
+    }
+
     // Start the disk streaming thread if streaming is enabled
     if (streamingEnabled && diskStreamer != nullptr)
     {
         diskStreamer->startThread();
     }
 
+    renderPool.prepareToPlay(sampleRate, samplesPerBlock);
+
+    // Build the polyphase sinc table now so the first high-quality note
+    // never pays for it on the audio thread
+    Resampler::getSincTable();
+
+    // Render budget for the governor: the wall time one block may take
+    blockBudgetUs = sampleRate > 0.0 ? samplesPerBlock / sampleRate * 1.0e6 : 0.0;
+    blockTimesUs.fill(0);
+    blockTimeIndex = 0;
+    governorShedLevel = 0;
+    lastGovernorStepMs = 0;
+    appliedQualityIndex = -1;  // re-push quality after any governor cap
+
     updateADSR();
 }
 
 void SuperSimpleSamplerProcessor::releaseResources()
 {
+    renderPool.releaseResources();
 }
 
 bool SuperSimpleSamplerProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -179,12 +243,19 @@ void SuperSimpleSamplerProcessor::updateADSR()
     adsrParams.sustain = sustainParam->load();
     adsrParams.release = releaseParam->load();
 
-    for (int i = 0; i < sampler.getNumVoices(); ++i)
+    for (auto* voice : samplerVoices)
     {
-        if (auto* voice = dynamic_cast<SampleZoneVoice*>(sampler.getVoice(i)))
-        {
-            voice->setADSRParameters(adsrParams);
-        }
+        voice->setADSRParameters(adsrParams);
+    }
+
+    for (auto& voice : streamingVoices)
+    {
+        voice.setADSRParameters(adsrParams);
+    }
+
+    for (auto& voice : preloadVoices)
+    {
+        voice.setADSRParameters(adsrParams);
     }
 }
 
@@ -192,10 +263,65 @@ void SuperSimpleSamplerProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                                 juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    auto callbackStartTicks = juce::Time::getHighResolutionTicks();
+
+    // Ticks even when the gates below return early: retired sample sets are
+    // only reclaimed once this has advanced past their retirement, so the
+    // sweep can prove no callback still holds the old raw set pointer
+    renderBlockCounter.fetch_add(1, std::memory_order_release);
 
     buffer.clear();
 
-    updateADSR();
+    // A restore has been requested: any voices still sounding the outgoing
+    // instrument are cut here, on the thread that renders them, so voice
+    // state is never mutated under an in-flight block. Checked outside the
+    // gate below because a fast load can finish before this callback runs.
+    if (silenceVoicesForRestore.exchange(false, std::memory_order_acq_rel))
+    {
+        for (auto* voice : samplerVoices)
+            voice->stopNote(0.0f, false);
+        for (auto& voice : streamingVoices)
+            voice.reset();
+        for (auto& voice : preloadVoices)
+            voice.reset();
+    }
+
+    // A state restore is still loading its instrument on the loader thread;
+    // return silence rather than touching instrument data mid-swap
+    if (!instrumentReady.load(std::memory_order_acquire))
+        return;
+
+    // Re-apply envelope settings only when a knob actually moved
+    auto currentEpoch = adsrParamEpoch.load(std::memory_order_acquire);
+    if (currentEpoch != appliedAdsrEpoch)
+    {
+        updateADSR();
+        appliedAdsrEpoch = currentEpoch;
+    }
+
+    // Re-evaluate the render budget governor against the last window of
+    // block times before committing to this block's workload
+    updateRenderGovernor();
+
+    // Push the resampling quality to the voices when it changes; each voice
+    // latches it at note start so running notes keep their kernel. The
+    // governor caps the user's choice while load is being shed.
+    int qualityIndex = static_cast<int>(qualityParam->load() + 0.5f);
+    int qualityCap = governorShedLevel >= 2 ? 0 : (governorShedLevel == 1 ? 1 : 2);
+    int effectiveQuality = std::min(qualityIndex, qualityCap);
+    if (effectiveQuality != appliedQualityIndex)
+    {
+        auto resampleQuality = Resampler::fromParameterValue(static_cast<float>(effectiveQuality));
+
+        for (auto* voice : samplerVoices)
+            voice->setResampleQuality(resampleQuality);
+        for (auto& voice : streamingVoices)
+            voice.setResampleQuality(resampleQuality);
+        for (auto& voice : preloadVoices)
+            voice.setResampleQuality(resampleQuality);
+
+        appliedQualityIndex = effectiveQuality;
+    }
 
     // Route to appropriate processing method based on streaming mode
     if (streamingEnabled)
@@ -240,6 +366,122 @@ void SuperSimpleSamplerProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     // Apply gain
     float gain = gainParam->load();
     buffer.applyGain(gain);
+
+    double callbackSeconds = juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - callbackStartTicks);
+    streamingMetrics.recordCallback(static_cast<juce::uint32>(callbackSeconds * 1.0e6));
+
+    // Feed the governor's rolling window
+    blockTimesUs[static_cast<size_t>(blockTimeIndex)] = static_cast<juce::uint32>(callbackSeconds * 1.0e6);
+    blockTimeIndex = (blockTimeIndex + 1) % governorWindowSize;
+}
+
+void SuperSimpleSamplerProcessor::updateRenderGovernor()
+{
+    if (blockBudgetUs <= 0.0)
+        return;
+
+    // Count how the window sits against the budget. Escalation keys off the
+    // worst few blocks (roughly the window's p90), not the mean: a glitch
+    // comes from one bad block, and the mean hides it.
+    const auto escalateUs = static_cast<juce::uint32>(blockBudgetUs * governorEscalateFraction);
+    const auto relaxUs = static_cast<juce::uint32>(blockBudgetUs * governorRelaxFraction);
+
+    int hotBlocks = 0;
+    int warmBlocks = 0;
+    for (auto timeUs : blockTimesUs)
+    {
+        if (timeUs >= escalateUs)
+            ++hotBlocks;
+        if (timeUs >= relaxUs)
+            ++warmBlocks;
+    }
+
+    const bool hot = hotBlocks >= governorWindowSize / 8;
+    const auto nowMs = juce::Time::getMillisecondCounter();
+
+    if (hot)
+    {
+        // Step up at most every 250ms so one level's relief can register in
+        // the window before the next is taken
+        if (governorShedLevel < 3 && nowMs - lastGovernorStepMs >= 250)
+        {
+            ++governorShedLevel;
+            lastGovernorStepMs = nowMs;
+            streamingMetrics.noteLoadShed();
+        }
+
+        // At the last level keep fading the quietest voice while blocks
+        // stay hot; the candidates are decayed tails, so each one goes
+        // almost unheard but still pays full render cost. One cull per
+        // 50ms: sustained overload thins the mix a voice at a time instead
+        // of culling on every hot callback.
+        if (governorShedLevel >= 3 && nowMs - lastVoiceShedMs >= 50)
+        {
+            shedQuietestVoice();
+            lastVoiceShedMs = nowMs;
+        }
+    }
+    else if (governorShedLevel > 0 && warmBlocks == 0 && nowMs - lastGovernorStepMs >= 2000)
+    {
+        // The whole window is comfortably clear - back off one level, again
+        // rate-limited so recovery can't oscillate against escalation
+        --governorShedLevel;
+        lastGovernorStepMs = nowMs;
+    }
+}
+
+void SuperSimpleSamplerProcessor::shedQuietestVoice()
+{
+    float bestLevel = std::numeric_limits<float>::max();
+    SampleZoneVoice* bestSampler = nullptr;
+    StreamingVoice* bestStreaming = nullptr;
+    PreloadVoice* bestPreload = nullptr;
+
+    // Voices already fading out are spoken for - skip them so one decision
+    // doesn't get re-taken (and re-counted) while its ramp completes
+    for (auto* voice : samplerVoices)
+    {
+        if (voice->isPlaying() && !voice->isShedding() && voice->getEnvelopeLevel() < bestLevel)
+        {
+            bestLevel = voice->getEnvelopeLevel();
+            bestSampler = voice;
+        }
+    }
+
+    for (auto& voice : streamingVoices)
+    {
+        if (voice.isActive() && !voice.isShedding() && voice.getEnvelopeLevel() < bestLevel)
+        {
+            bestLevel = voice.getEnvelopeLevel();
+            bestSampler = nullptr;
+            bestStreaming = &voice;
+        }
+    }
+
+    for (auto& voice : preloadVoices)
+    {
+        if (voice.isActive() && !voice.isShedding() && voice.getEnvelopeLevel() < bestLevel)
+        {
+            bestLevel = voice.getEnvelopeLevel();
+            bestSampler = nullptr;
+            bestStreaming = nullptr;
+            bestPreload = &voice;
+        }
+    }
+
+    // The voice ramps to silence over the steal-fade length and then frees
+    // itself, so a cull never lands as a hard cut
+    if (bestPreload != nullptr)
+        bestPreload->beginShedFadeOut();
+    else if (bestStreaming != nullptr)
+        bestStreaming->beginShedFadeOut();
+    else if (bestSampler != nullptr)
+        bestSampler->beginShedFadeOut();
+    else
+        return;  // nothing active to shed
+
+    streamingMetrics.noteLoadShed();
 }
 
 bool SuperSimpleSamplerProcessor::hasEditor() const { return true; }
@@ -261,6 +503,10 @@ void SuperSimpleSamplerProcessor::getStateInformation(juce::MemoryBlock& destDat
                           nullptr);
     }
 
+    // Streaming mode must restore before the instrument so the reopen can
+    // route to the cheap streaming loader instead of the full RAM decode
+    state.setProperty("streamingMode", streamingEnabled, nullptr);
+
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
 }
@@ -275,20 +521,74 @@ void SuperSimpleSamplerProcessor::setStateInformation(const void* data, int size
             auto state = juce::ValueTree::fromXml(*xmlState);
             parameters.replaceState(state);
 
-            // Restore instrument
+            setStreamingEnabled(state.getProperty("streamingMode", streamingEnabled));
+
+            // Restore the instrument on the loader thread: the full decode of
+            // a large library takes seconds per instance, and a session with
+            // several of us open must not stall the DAW for the sum of them
             auto instrumentPath = state.getProperty("instrumentPath").toString();
             if (instrumentPath.isNotEmpty())
             {
                 juce::File instrumentFile(instrumentPath);
                 if (instrumentFile.existsAsFile())
                 {
-                    loadInstrumentFromFile(instrumentFile);
+                    restoreInstrumentAsync(instrumentFile, streamingEnabled);
                 }
             }
         }
     }
 }
 
+void SuperSimpleSamplerProcessor::restoreInstrumentAsync(const juce::File& definitionFile, bool streaming)
+{
+    // Gate the audio thread to silence for the whole load. The gate goes up
+    // before the thread starts, so at most the block already in flight still
+    // touches the old instrument data - which stays valid under it: voices
+    // hold refcounted sounds (RAM path) or a retained set (streaming path).
+    // Voices are deliberately not reset here; processBlock does that when
+    // it sees the flag, so no voice is ever mutated mid-render.
+    silenceVoicesForRestore.store(true, std::memory_order_release);
+    instrumentReady.store(false, std::memory_order_release);
+
+    // Editors hold raw pointers into the outgoing instrument's zones; they
+    // drop them on the message thread before anything is replaced
+    notifyInstrumentAboutToChange();
+
+    if (stateRestoreThread.joinable())
+        stateRestoreThread.join();
+
+    // The destructor joins this thread, so `this` outlives the load
+    stateRestoreThread = std::thread([this, definitionFile, streaming]()
+    {
+        if (streaming)
+        {
+            // The streaming load builds its set off to the side and swaps it
+            // with one atomic publish, so it is safe to run here in full
+            loadInstrumentStreaming(definitionFile);
+            instrumentReady.store(true, std::memory_order_release);
+        }
+        else
+        {
+            // Decode here, swap on the message thread: the editor reads
+            // currentInstrument.zones there (sample list rows, the waveform
+            // display), so reassigning it from this thread would destroy
+            // zones out from under a paint in progress
+            auto loaded = std::make_shared<LoadedInstrument>(
+                instrumentLoader.loadInstrument(definitionFile));
+
+            juce::WeakReference<SuperSimpleSamplerProcessor> weakThis(this);
+            juce::MessageManager::callAsync([weakThis, loaded]()
+            {
+                if (auto* self = weakThis.get())
+                {
+                    self->applyLoadedInstrument(std::move(*loaded));
+                    self->instrumentReady.store(true, std::memory_order_release);
+                }
+            });
+        }
+    });
+}
+
 std::vector<InstrumentInfo> SuperSimpleSamplerProcessor::getAvailableInstruments()
 {
     return availableInstruments;
@@ -296,7 +596,31 @@ std::vector<InstrumentInfo> SuperSimpleSamplerProcessor::getAvailableInstruments
 
 void SuperSimpleSamplerProcessor::refreshInstrumentList()
 {
-    availableInstruments = instrumentLoader.scanForInstruments();
+    // The walk (and any XML parsing the scan cache can't avoid) runs on a
+    // background thread so instantiation and the refresh button never block
+    // the message thread on directory I/O; results land via callAsync.
+    bool expected = false;
+    if (!scanInProgress.compare_exchange_strong(expected, true))
+        return;  // a scan is already running
+
+    if (instrumentScanThread.joinable())
+        instrumentScanThread.join();  // previous scan has finished; reclaim it
+
+    juce::WeakReference<SuperSimpleSamplerProcessor> weakThis(this);
+    instrumentScanThread = std::thread([this, weakThis]()
+    {
+        auto results = instrumentLoader.scanForInstruments();
+
+        juce::MessageManager::callAsync([weakThis, results = std::move(results)]() mutable
+        {
+            if (auto* self = weakThis.get())
+            {
+                self->availableInstruments = std::move(results);
+                self->scanInProgress.store(false);
+                self->listeners.call([](Listener& l) { l.instrumentListChanged(); });
+            }
+        });
+    });
 }
 
 void SuperSimpleSamplerProcessor::loadInstrument(int index)
@@ -309,10 +633,24 @@ void SuperSimpleSamplerProcessor::loadInstrument(int index)
 
 void SuperSimpleSamplerProcessor::loadInstrumentFromFile(const juce::File& definitionFile)
 {
-    currentInstrument = instrumentLoader.loadInstrument(definitionFile);
+    applyLoadedInstrument(instrumentLoader.loadInstrument(definitionFile));
+}
+
+void SuperSimpleSamplerProcessor::applyLoadedInstrument(LoadedInstrument loaded)
+{
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    // Editors retain raw pointers into the outgoing zones (the waveform
+    // display, the sample list rows); have them let go before the
+    // assignment below destroys the zones and their audio buffers
+    listeners.call([](Listener& l) { l.instrumentAboutToChange(); });
+
+    currentInstrument = std::move(loaded);
 
     // Reset round-robin counters for new instrument
-    roundRobinCounters.clear();
+    roundRobinCounters.fill(0);
+    lastPlayedPacked.store(0, std::memory_order_relaxed);
+    noteOnTimesMs.fill(0);
 
     if (currentInstrument.isValid())
     {
@@ -323,6 +661,7 @@ void SuperSimpleSamplerProcessor::loadInstrumentFromFile(const juce::File& defin
     {
         selectedZoneIndex = -1;
         sampler.clearSounds();
+        zoneLookup.clear();
     }
 
     notifyListeners();
@@ -330,9 +669,11 @@ void SuperSimpleSamplerProcessor::loadInstrumentFromFile(const juce::File& defin
 
 void SuperSimpleSamplerProcessor::unloadInstrument()
 {
+    notifyInstrumentAboutToChange();
     currentInstrument = LoadedInstrument();
     selectedZoneIndex = -1;
     sampler.clearSounds();
+    zoneLookup.clear();
     notifyListeners();
 }
 
@@ -348,18 +689,61 @@ const SampleZone* SuperSimpleSamplerProcessor::getSelectedZone() const
     return getZone(selectedZoneIndex);
 }
 
+juce::String SuperSimpleSamplerProcessor::getLastPlayedSample() const
+{
+    auto packed = lastPlayedPacked.load(std::memory_order_relaxed);
+    if (packed == 0)
+        return {};
+
+    bool streaming = (packed >> 32) != 0;
+    int sampleIndex = static_cast<int>((packed >> 16) & 0xffff);
+    int rrIndex = static_cast<int>((packed >> 8) & 0xff);
+    int numMatches = static_cast<int>(packed & 0xff);
+
+    juce::String name;
+    if (streaming)
+    {
+        if (auto set = std::atomic_load(&activeSampleSet))
+            if (sampleIndex >= 0 && sampleIndex < static_cast<int>(set->samples.size()))
+                name = set->samples[static_cast<size_t>(sampleIndex)].name;
+    }
+    else
+    {
+        if (auto* zoneSound = dynamic_cast<SampleZoneSound*>(sampler.getSound(sampleIndex).get()))
+            name = zoneSound->getZone().name;
+    }
+
+    if (name.isEmpty())
+        return {};
+
+    return name + " (RR" + juce::String(rrIndex + 1) + "/" + juce::String(numMatches) + ")";
+}
+
 void SuperSimpleSamplerProcessor::rebuildSampler()
 {
     sampler.clearSounds();
+    zoneLookup.beginBuild();
+    releaseZoneLookup.beginBuild();
 
     for (const auto& zone : currentInstrument.zones)
     {
         if (zone.isValid())
         {
+            // The lookup is indexed by sound slot, which only counts valid
+            // zones; release-trigger zones go in their own index so a
+            // note-on can never match them
+            int soundIndex = sampler.getNumSounds();
             sampler.addSound(new SampleZoneSound(zone));
+
+            auto& lookup = zone.releaseTrigger ? releaseZoneLookup : zoneLookup;
+            lookup.addZone(soundIndex, zone.lowNote, zone.highNote,
+                           zone.lowVelocity, zone.highVelocity);
         }
     }
 
+    zoneLookup.finishBuild();
+    releaseZoneLookup.finishBuild();
+
     debugLog("=== Sampler rebuilt: " + juce::String(sampler.getNumSounds()) + " sounds loaded ===");
     for (int i = 0; i < sampler.getNumSounds(); ++i)
     {
@@ -375,26 +759,40 @@ void SuperSimpleSamplerProcessor::rebuildSampler()
 
 void SuperSimpleSamplerProcessor::notifyListeners()
 {
+    // Loads can finish on a background thread (the state restore), but
+    // ListenerList is not thread-safe - marshal onto the message thread
+    // the same way the scan thread delivers its results
+    if (!juce::MessageManager::getInstance()->isThisTheMessageThread())
+    {
+        juce::WeakReference<SuperSimpleSamplerProcessor> weakThis(this);
+        juce::MessageManager::callAsync([weakThis]()
+        {
+            if (auto* self = weakThis.get())
+                self->listeners.call([](Listener& l) { l.instrumentChanged(); });
+        });
+        return;
+    }
+
     listeners.call([](Listener& l) { l.instrumentChanged(); });
 }
 
-std::vector<int> SuperSimpleSamplerProcessor::findMatchingZones(int midiNote, int velocity)
+void SuperSimpleSamplerProcessor::notifyInstrumentAboutToChange()
 {
-    std::vector<int> matches;
-
-    for (int i = 0; i < sampler.getNumSounds(); ++i)
+    // Same marshalling as notifyListeners: hosts may call setStateInformation
+    // off the message thread, and message-queue ordering guarantees this
+    // lands before the restore's own swap callback
+    if (!juce::MessageManager::getInstance()->isThisTheMessageThread())
     {
-        if (auto* sound = dynamic_cast<SampleZoneSound*>(sampler.getSound(i).get()))
+        juce::WeakReference<SuperSimpleSamplerProcessor> weakThis(this);
+        juce::MessageManager::callAsync([weakThis]()
         {
-            const auto& zone = sound->getZone();
-            if (zone.matches(midiNote, velocity))
-            {
-                matches.push_back(i);
-            }
-        }
+            if (auto* self = weakThis.get())
+                self->listeners.call([](Listener& l) { l.instrumentAboutToChange(); });
+        });
+        return;
     }
 
-    return matches;
+    listeners.call([](Listener& l) { l.instrumentAboutToChange(); });
 }
 
 void SuperSimpleSamplerProcessor::handleNoteOn(int midiChannel, int midiNote, float velocity)
@@ -403,56 +801,79 @@ void SuperSimpleSamplerProcessor::handleNoteOn(int midiChannel, int midiNote, fl
 
     int intVelocity = static_cast<int>(velocity * 127.0f);
 
-    // Find all zones that match this note AND velocity
-    auto matchingZones = findMatchingZones(midiNote, intVelocity);
+    // Resolve matching zones through the precomputed index (no allocation)
+    std::array<int, ZoneLookup::maxMatchesPerNote> matchingZones;
+    int numMatches = zoneLookup.findMatches(midiNote, intVelocity,
+                                            matchingZones.data(),
+                                            static_cast<int>(matchingZones.size()));
 
-    if (matchingZones.empty())
+    if (numMatches == 0)
         return;
 
     // Per-note round-robin (like SFZ seq_position)
-    int& rrCounter = roundRobinCounters[midiNote];
-    int numMatches = static_cast<int>(matchingZones.size());
+    int& rrCounter = roundRobinCounters[static_cast<size_t>(midiNote & 0x7f)];
     int rrIndex = rrCounter % numMatches;
     int selectedIndex = matchingZones[static_cast<size_t>(rrIndex)];
 
-    debugLog("Note " + juce::String(midiNote) + " vel " + juce::String(intVelocity)
-             + " | matches=" + juce::String(numMatches)
-             + " | rrCounter=" + juce::String(rrCounter)
-             + " | rrIndex=" + juce::String(rrIndex)
-             + " | selectedIdx=" + juce::String(selectedIndex));
+    // Remember when and how hard this note started, for its release layer
+    noteOnTimesMs[static_cast<size_t>(midiNote & 0x7f)] = juce::Time::getMillisecondCounter();
+    noteOnVelocities[static_cast<size_t>(midiNote & 0x7f)] = velocity;
+
+    Trace::post(Trace::Event::noteOn, -1, midiNote, intVelocity, rrIndex, numMatches);
 
     rrCounter++;
 
     auto* selectedSound = sampler.getSound(selectedIndex).get();
 
-    // Store last played sample name for debug display
-    if (auto* zoneSound = dynamic_cast<SampleZoneSound*>(selectedSound))
-    {
-        lastPlayedSample = zoneSound->getZone().name + " (RR" + juce::String(rrIndex + 1) + "/" + juce::String(numMatches) + ")";
-        debugLog("  -> Playing: " + lastPlayedSample);
-    }
+    // Record what played as a single packed store; the editor's timer
+    // formats it into the display string off the audio thread
+    lastPlayedPacked.store(packLastPlayed(selectedIndex, rrIndex, numMatches, false),
+                           std::memory_order_relaxed);
 
     // Get current polyphony setting
     int maxVoices = static_cast<int>(polyphonyParam->load());
 
     // Find a free voice within the polyphony limit
+    maxVoices = std::min(maxVoices, static_cast<int>(samplerVoices.size()));
     for (int i = 0; i < maxVoices; ++i)
     {
-        if (auto* voice = dynamic_cast<SampleZoneVoice*>(sampler.getVoice(i)))
+        auto* voice = samplerVoices[static_cast<size_t>(i)];
+        if (!voice->isPlaying())
         {
-            if (!voice->isPlaying())
-            {
-                voice->startNote(midiNote, velocity, selectedSound, 0);
-                return;
-            }
+            voice->startNote(midiNote, velocity, selectedSound, 0);
+            return;
         }
     }
 
-    // If no free voice, steal the first one (voice stealing)
-    if (auto* voice = dynamic_cast<SampleZoneVoice*>(sampler.getVoice(0)))
+    // No free voice: steal the least audible one. Releasing voices score by
+    // their current envelope level so the quietest tail goes first; held
+    // voices score above all releasing ones and by age so the oldest wins.
+    if (!samplerVoices.empty())
     {
-        voice->stopNote(0.0f, false);
-        voice->startNote(midiNote, velocity, selectedSound, 0);
+        const auto nowMs = juce::Time::getMillisecondCounter();
+        SampleZoneVoice* best = samplerVoices.front();
+        float bestScore = std::numeric_limits<float>::max();
+
+        for (int i = 0; i < maxVoices; ++i)
+        {
+            auto* voice = samplerVoices[static_cast<size_t>(i)];
+            float score;
+
+            if (voice->isReleasing())
+                score = voice->getEnvelopeLevel();
+            else
+                score = 2.0f + 1.0f / (1.0f + static_cast<float>(nowMs - voice->getNoteStartMs()));
+
+            if (score < bestScore)
+            {
+                bestScore = score;
+                best = voice;
+            }
+        }
+
+        best->stopNote(0.0f, false);
+        best->startNote(midiNote, velocity, selectedSound, 0);
+        best->applyStealFadeIn();
     }
 }
 
@@ -461,14 +882,63 @@ void SuperSimpleSamplerProcessor::handleNoteOff(int midiChannel, int midiNote, f
     juce::ignoreUnused(midiChannel, velocity);
 
     // Release all voices playing this note (respecting sustain pedal)
-    for (int i = 0; i < sampler.getNumVoices(); ++i)
+    for (auto* voice : samplerVoices)
     {
-        if (auto* voice = dynamic_cast<SampleZoneVoice*>(sampler.getVoice(i)))
+        if (voice->isPlaying() && voice->getPlayingNote() == midiNote)
         {
-            if (voice->isPlaying() && voice->getPlayingNote() == midiNote)
-            {
-                voice->noteReleasedWithPedal(sustainPedalDown);
-            }
+            voice->noteReleasedWithPedal(sustainPedalDown);
+        }
+    }
+
+    // With the pedal down the damper never falls, so no release sample
+    // (the eventual pedal lift releases everything at once - firing a
+    // full chord of dampers there would be worse than none)
+    if (!sustainPedalDown)
+        triggerReleaseSamples(midiNote);
+}
+
+float SuperSimpleSamplerProcessor::releaseVelocityFor(int midiNote) const
+{
+    auto startedMs = noteOnTimesMs[static_cast<size_t>(midiNote & 0x7f)];
+    if (startedMs == 0)
+        return 0.0f;
+
+    // rt_decay-style: attenuate by how long the note was held, tracking the
+    // decayed energy of the string the damper lands on
+    float heldSeconds = static_cast<float>(juce::Time::getMillisecondCounter() - startedMs) / 1000.0f;
+    float velocity = noteOnVelocities[static_cast<size_t>(midiNote & 0x7f)]
+                     * juce::Decibels::decibelsToGain(-releaseDecayDbPerSecond * heldSeconds);
+
+    return velocity >= 0.01f ? velocity : 0.0f;
+}
+
+void SuperSimpleSamplerProcessor::triggerReleaseSamples(int midiNote)
+{
+    float velocity = releaseVelocityFor(midiNote);
+    if (velocity <= 0.0f)
+        return;
+
+    std::array<int, ZoneLookup::maxMatchesPerNote> matchingZones;
+    int numMatches = releaseZoneLookup.findMatches(midiNote, static_cast<int>(velocity * 127.0f),
+                                                   matchingZones.data(),
+                                                   static_cast<int>(matchingZones.size()));
+    if (numMatches == 0)
+        return;
+
+    // Pair the release with its note-on's round-robin position (the counter
+    // was advanced at note-on, so step back one)
+    int rrCounter = roundRobinCounters[static_cast<size_t>(midiNote & 0x7f)];
+    int rrIndex = (rrCounter + numMatches - 1) % numMatches;
+    auto* sound = sampler.getSound(matchingZones[static_cast<size_t>(rrIndex)]).get();
+
+    // Free voices only: release layers are ornamental, so under voice
+    // pressure they are dropped rather than stealing a musical note
+    for (auto* voice : samplerVoices)
+    {
+        if (!voice->isPlaying())
+        {
+            voice->startNote(midiNote, velocity, sound, 0);
+            return;
         }
     }
 }
@@ -480,12 +950,9 @@ void SuperSimpleSamplerProcessor::handleSustainPedal(bool isDown)
     if (!isDown)
     {
         // Pedal released - release all sustained notes
-        for (int i = 0; i < sampler.getNumVoices(); ++i)
+        for (auto* voice : samplerVoices)
         {
-            if (auto* voice = dynamic_cast<SampleZoneVoice*>(sampler.getVoice(i)))
-            {
-                voice->setSustainPedal(false);
-            }
+            voice->setSustainPedal(false);
         }
     }
 }
@@ -533,61 +1000,117 @@ void SuperSimpleSamplerProcessor::setStreamingEnabled(bool enabled)
 
 void SuperSimpleSamplerProcessor::loadInstrumentStreaming(const juce::File& definitionFile)
 {
-    // Clear existing preloaded samples
-    preloadedSamples.clear();
+    // Build the replacement set off to the side; the currently published set
+    // stays live (and playable) until the single atomic swap below
+    auto newSet = std::make_shared<PreloadedSampleSet>();
 
     // Reset round-robin counters
-    roundRobinCounters.clear();
-
-    auto xml = juce::XmlDocument::parse(definitionFile);
-    if (xml == nullptr || !xml->hasTagName("SuperSimpleSampler"))
-    {
-        notifyListeners();
-        return;
-    }
+    roundRobinCounters.fill(0);
+    lastPlayedPacked.store(0, std::memory_order_relaxed);
+    noteOnTimesMs.fill(0);
 
     // Store instrument info
     currentInstrument.info.definitionFile = definitionFile;
     currentInstrument.info.folder = definitionFile.getParentDirectory();
 
-    // Parse meta
-    if (auto* meta = xml->getChildByName("meta"))
+    // Fast path: a valid compiled sidecar replaces the XML parse and every
+    // per-file header scan with one sequential read
+    if (InstrumentCache::load(definitionFile, preloadPolicy, currentInstrument.info.name,
+                              currentInstrument.info.author, newSet->samples))
     {
-        if (auto* nameElem = meta->getChildByName("name"))
-            currentInstrument.info.name = nameElem->getAllSubText().trim();
-        if (auto* authorElem = meta->getChildByName("author"))
-            currentInstrument.info.author = authorElem->getAllSubText().trim();
-    }
+        preloadTotal.store(static_cast<int>(newSet->samples.size()), std::memory_order_relaxed);
+        preloadProgress.store(static_cast<int>(newSet->samples.size()), std::memory_order_relaxed);
 
-    // Parse samples - load as preloaded samples (partial load)
-    if (auto* samples = xml->getChildByName("samples"))
+        debugLog("Loaded " + juce::String(newSet->samples.size())
+                 + " samples from compiled cache: "
+                 + InstrumentCache::getCacheFileFor(definitionFile).getFullPathName());
+    }
+    else
     {
-        for (auto* sampleElem : samples->getChildIterator())
+        auto xml = juce::XmlDocument::parse(definitionFile);
+        if (xml == nullptr || !xml->hasTagName("SuperSimpleSampler"))
         {
-            if (sampleElem->hasTagName("sample"))
+            notifyListeners();
+            return;
+        }
+
+        // Parse meta
+        if (auto* meta = xml->getChildByName("meta"))
+        {
+            if (auto* nameElem = meta->getChildByName("name"))
+                currentInstrument.info.name = nameElem->getAllSubText().trim();
+            if (auto* authorElem = meta->getChildByName("author"))
+                currentInstrument.info.author = authorElem->getAllSubText().trim();
+        }
+
+        // Optional per-instrument preload tuning, e.g. <preload sizeKB="128"/>
+        // (slow NAS libraries want more headroom; huge one-shot sets want less)
+        preloadPolicy.basePreloadBytes = PreloadedSample::preloadSizeBytes;
+        if (auto* preload = xml->getChildByName("preload"))
+        {
+            int sizeKB = preload->getIntAttribute("sizeKB", 0);
+            if (sizeKB > 0)
+                preloadPolicy.basePreloadBytes = juce::jlimit(PreloadPolicy::minPreloadBytes,
+                                                              PreloadPolicy::maxPreloadBytes,
+                                                              sizeKB * 1024);
+        }
+
+        // Parse samples first (cheap), then fan the preload reads out across worker threads
+        std::vector<PendingSampleEntry> pendingEntries;
+
+        if (auto* samples = xml->getChildByName("samples"))
+        {
+            for (auto* sampleElem : samples->getChildIterator())
             {
-                PreloadedSample sample;
+                if (sampleElem->hasTagName("sample"))
+                {
+                    PendingSampleEntry entry;
+
+                    auto filePath = sampleElem->getStringAttribute("file");
+                    entry.file = currentInstrument.info.folder.getChildFile(filePath);
 
-                // Get file path
-                auto filePath = sampleElem->getStringAttribute("file");
-                auto sampleFile = currentInstrument.info.folder.getChildFile(filePath);
+                    entry.rootNote = sampleElem->getIntAttribute("rootNote", 60);
+                    entry.lowNote = sampleElem->getIntAttribute("loNote", 0);
+                    entry.highNote = sampleElem->getIntAttribute("hiNote", 127);
+                    entry.lowVelocity = sampleElem->getIntAttribute("loVel", 1);
+                    entry.highVelocity = sampleElem->getIntAttribute("hiVel", 127);
 
-                if (!loadPreloadedSample(sampleFile, sample))
-                    continue;
+                    entry.releaseTrigger = sampleElem->getStringAttribute("trigger") == "release";
 
-                // Parse mapping attributes
-                sample.rootNote = sampleElem->getIntAttribute("rootNote", 60);
-                sample.lowNote = sampleElem->getIntAttribute("loNote", 0);
-                sample.highNote = sampleElem->getIntAttribute("hiNote", 127);
-                sample.lowVelocity = sampleElem->getIntAttribute("loVel", 1);
-                sample.highVelocity = sampleElem->getIntAttribute("hiVel", 127);
+                    if (sampleElem->hasAttribute("loopStart") || sampleElem->hasAttribute("loopEnd"))
+                    {
+                        entry.loopStart = sampleElem->getIntAttribute("loopStart", 0);
+                        entry.loopEnd = sampleElem->getIntAttribute("loopEnd", 0);
+                    }
 
-                preloadedSamples.push_back(std::move(sample));
+                    pendingEntries.push_back(std::move(entry));
+                }
             }
         }
+
+        computePreloadSizes(pendingEntries);
+        loadPreloadsParallel(pendingEntries, newSet->samples);
+
+        // Compile the sidecar so the next load of this instrument is one read
+        if (!newSet->samples.empty())
+            InstrumentCache::save(definitionFile, preloadPolicy, currentInstrument.info.name,
+                                  currentInstrument.info.author, newSet->samples);
+    }
+
+    // Build the resolution indices into the set before publishing it;
+    // release triggers get their own so note-ons can never match them
+    newSet->lookup.beginBuild();
+    newSet->releaseLookup.beginBuild();
+    for (int i = 0; i < static_cast<int>(newSet->samples.size()); ++i)
+    {
+        const auto& s = newSet->samples[static_cast<size_t>(i)];
+        auto& lookup = s.releaseTrigger ? newSet->releaseLookup : newSet->lookup;
+        lookup.addZone(i, s.lowNote, s.highNote, s.lowVelocity, s.highVelocity);
     }
+    newSet->lookup.finishBuild();
+    newSet->releaseLookup.finishBuild();
 
-    if (!preloadedSamples.empty())
+    if (!newSet->samples.empty())
     {
         selectedZoneIndex = 0;
     }
@@ -596,12 +1119,26 @@ void SuperSimpleSamplerProcessor::loadInstrumentStreaming(const juce::File& defi
         selectedZoneIndex = -1;
     }
 
+    // Publish: the shared_ptr swap first (message-thread readers), then the
+    // raw mirror the audio thread snapshots. Between the two stores the
+    // audio thread still sees the old set, which the retire list keeps
+    // alive; its destructor runs here on the message thread once the last
+    // playing voice has dropped its reference and the block counter shows
+    // no callback from before the swap is still in flight.
+    auto previous = std::atomic_exchange(&activeSampleSet,
+                                         std::shared_ptr<const PreloadedSampleSet>(newSet));
+    activeSampleSetPtr.store(newSet.get(), std::memory_order_release);
+    if (previous != nullptr)
+        retiredSets.push_back({ std::move(previous),
+                                renderBlockCounter.load(std::memory_order_acquire) });
+    sweepRetiredSets();
+
     // Calculate and log memory usage summary
     size_t totalPreloadBytes = 0;
     size_t totalFullSampleBytes = 0;
     int streamingSamples = 0;
 
-    for (const auto& s : preloadedSamples)
+    for (const auto& s : newSet->samples)
     {
         totalPreloadBytes += static_cast<size_t>(s.preloadBuffer.getNumSamples() * s.numChannels * sizeof(float));
         totalFullSampleBytes += static_cast<size_t>(s.totalSampleFrames * s.numChannels * sizeof(float));
@@ -610,7 +1147,7 @@ void SuperSimpleSamplerProcessor::loadInstrumentStreaming(const juce::File& defi
     }
 
     debugLog("=== STREAMING MODE SUMMARY ===");
-    debugLog("  Total samples: " + juce::String(preloadedSamples.size()));
+    debugLog("  Total samples: " + juce::String(newSet->samples.size()));
     debugLog("  Samples needing streaming: " + juce::String(streamingSamples));
     debugLog("  Preload memory: " + juce::String(totalPreloadBytes / 1024) + " KB ("
              + juce::String(totalPreloadBytes / (1024 * 1024)) + " MB)");
@@ -622,13 +1159,156 @@ void SuperSimpleSamplerProcessor::loadInstrumentStreaming(const juce::File& defi
     notifyListeners();
 }
 
-bool SuperSimpleSamplerProcessor::loadPreloadedSample(const juce::File& sampleFile, PreloadedSample& sample)
+void SuperSimpleSamplerProcessor::computePreloadSizes(std::vector<PendingSampleEntry>& entries) const
+{
+    if (entries.empty())
+        return;
+
+    // First pass: weighted desired size per sample. Release triggers get
+    // the full per-sample cap so short release material never streams - the
+    // point of the feature is that note-offs add zero disk work.
+    int64_t totalDesired = 0;
+    for (auto& entry : entries)
+    {
+        entry.preloadBytes = entry.releaseTrigger
+                                 ? PreloadPolicy::maxPreloadBytes
+                                 : preloadPolicy.weightedPreloadBytes(entry.rootNote);
+        totalDesired += entry.preloadBytes;
+    }
+
+    // Second pass: scale down proportionally if the budget is exceeded,
+    // never dropping below the per-sample floor. Short files are capped at
+    // their actual length when the preload is read, so the real total is
+    // usually well under this worst case. Release triggers keep their full
+    // preload - shrinking one below its file length would silently put it
+    // back on the disk thread.
+    if (totalDesired > preloadPolicy.ramBudgetBytes)
+    {
+        double scale = static_cast<double>(preloadPolicy.ramBudgetBytes)
+                       / static_cast<double>(totalDesired);
+
+        for (auto& entry : entries)
+        {
+            if (entry.releaseTrigger)
+                continue;
+
+            auto scaled = static_cast<int>(entry.preloadBytes * scale);
+            entry.preloadBytes = juce::jmax(PreloadPolicy::minPreloadBytes, scaled);
+        }
+    }
+}
+
+void SuperSimpleSamplerProcessor::sweepRetiredSets()
+{
+    // A use_count of 1 means only the retire list still holds the set: every
+    // voice that started on it has ended. The block counter must also have
+    // ticked at least twice since retirement - the callback in flight at the
+    // swap may have snapshotted the old raw pointer before the mirror store,
+    // and two ticks guarantee a whole block boundary strictly after it. With
+    // the transport stopped the free simply waits for callbacks to resume.
+    auto blocksNow = renderBlockCounter.load(std::memory_order_acquire);
+
+    retiredSets.erase(std::remove_if(retiredSets.begin(), retiredSets.end(),
+                                     [blocksNow](const RetiredSampleSet& retired)
+                                     {
+                                         return retired.set.use_count() == 1
+                                                && static_cast<juce::int32>(blocksNow - retired.retireBlock) >= 2;
+                                     }),
+                      retiredSets.end());
+}
+
+void SuperSimpleSamplerProcessor::loadPreloadsParallel(const std::vector<PendingSampleEntry>& entries,
+                                                       std::vector<PreloadedSample>& outSamples)
+{
+    const int numEntries = static_cast<int>(entries.size());
+
+    preloadProgress.store(0, std::memory_order_relaxed);
+    preloadTotal.store(numEntries, std::memory_order_relaxed);
+
+    if (numEntries == 0)
+        return;
+
+    // One worker per hardware thread, capped by entry count. Each worker owns its
+    // own format manager so reader creation never contends across threads.
+    int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    numThreads = juce::jlimit(1, numEntries, numThreads > 0 ? numThreads : 2);
+
+    std::vector<PreloadedSample> results(static_cast<size_t>(numEntries));
+    std::vector<char> loaded(static_cast<size_t>(numEntries), 0);
+    std::atomic<int> nextEntry{0};
+
+    auto worker = [this, &entries, &results, &loaded, &nextEntry, numEntries]()
+    {
+        juce::AudioFormatManager workerFormatManager;
+        workerFormatManager.registerBasicFormats();
+
+        for (;;)
+        {
+            int index = nextEntry.fetch_add(1, std::memory_order_relaxed);
+            if (index >= numEntries)
+                break;
+
+            const auto& entry = entries[static_cast<size_t>(index)];
+            auto& sample = results[static_cast<size_t>(index)];
+
+            if (loadPreloadedSample(workerFormatManager, entry.file, sample, entry.preloadBytes))
+            {
+                sample.rootNote = entry.rootNote;
+                sample.lowNote = entry.lowNote;
+                sample.highNote = entry.highNote;
+                sample.lowVelocity = entry.lowVelocity;
+                sample.highVelocity = entry.highVelocity;
+                sample.releaseTrigger = entry.releaseTrigger;
+
+                // Explicit XML loop points override the WAV smpl chunk
+                if (entry.loopStart >= 0 || entry.loopEnd >= 0)
+                {
+                    sample.loopStartFrame = std::max<int64_t>(entry.loopStart, 0);
+                    sample.loopEndFrame = std::max<int64_t>(entry.loopEnd, 0);
+                }
+
+                sample.loopStartFrame = juce::jlimit<int64_t>(0, sample.totalSampleFrames,
+                                                              sample.loopStartFrame);
+                sample.loopEndFrame = juce::jlimit<int64_t>(0, sample.totalSampleFrames,
+                                                            sample.loopEndFrame);
+
+                loaded[static_cast<size_t>(index)] = 1;
+            }
+
+            preloadProgress.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(static_cast<size_t>(numThreads - 1));
+
+    for (int i = 0; i < numThreads - 1; ++i)
+        pool.emplace_back(worker);
+
+    // The calling thread participates too
+    worker();
+
+    for (auto& thread : pool)
+        thread.join();
+
+    // Collect successful loads, preserving XML order
+    outSamples.reserve(static_cast<size_t>(numEntries));
+    for (int i = 0; i < numEntries; ++i)
+    {
+        if (loaded[static_cast<size_t>(i)])
+            outSamples.push_back(std::move(results[static_cast<size_t>(i)]));
+    }
+}
+
+bool SuperSimpleSamplerProcessor::loadPreloadedSample(juce::AudioFormatManager& manager,
+                                                      const juce::File& sampleFile, PreloadedSample& sample,
+                                                      int preloadBytes)
 {
     if (!sampleFile.existsAsFile())
         return false;
 
     std::unique_ptr<juce::AudioFormatReader> reader(
-        streamingFormatManager.createReaderFor(sampleFile));
+        manager.createReaderFor(sampleFile));
 
     if (reader == nullptr)
         return false;
@@ -640,10 +1320,17 @@ bool SuperSimpleSamplerProcessor::loadPreloadedSample(const juce::File& sampleFi
     sample.totalSampleFrames = static_cast<int64_t>(reader->lengthInSamples);
     sample.name = sampleFile.getFileNameWithoutExtension();
 
-    // Calculate preload size in frames
-    // 64KB / (channels * bytes per sample)
+    // Sustain loop from the WAV smpl chunk (XML attributes override later)
+    if (reader->metadataValues.getValue("NumSampleLoops", "0").getIntValue() > 0)
+    {
+        sample.loopStartFrame = reader->metadataValues.getValue("Loop0Start", "0").getLargeIntValue();
+        sample.loopEndFrame = reader->metadataValues.getValue("Loop0End", "0").getLargeIntValue();
+    }
+
+    // Calculate preload size in frames from this sample's byte budget
     int bytesPerSample = 4;  // 32-bit float
-    sample.preloadSizeFrames = PreloadedSample::preloadSizeBytes /
+    sample.preloadBytes = preloadBytes;
+    sample.preloadSizeFrames = preloadBytes /
                                (sample.numChannels * bytesPerSample);
 
     // Cap preload to total sample length
@@ -655,13 +1342,13 @@ bool SuperSimpleSamplerProcessor::loadPreloadedSample(const juce::File& sampleFi
     reader->read(&sample.preloadBuffer, 0, framesToPreload, 0, true, true);
 
     // Detailed logging
-    int preloadBytes = sample.preloadBuffer.getNumSamples() * sample.numChannels * bytesPerSample;
+    int actualPreloadBytes = sample.preloadBuffer.getNumSamples() * sample.numChannels * bytesPerSample;
     double durationSec = static_cast<double>(sample.totalSampleFrames) / sample.sampleRate;
     debugLog("Loaded preload: " + sample.name
              + " | totalFrames=" + juce::String(sample.totalSampleFrames)
              + " (" + juce::String(durationSec, 2) + "s)"
              + " | preloadFrames=" + juce::String(framesToPreload)
-             + " | preloadBytes=" + juce::String(preloadBytes)
+             + " | preloadBytes=" + juce::String(actualPreloadBytes)
              + " | channels=" + juce::String(sample.numChannels)
              + " | needsStreaming=" + juce::String(sample.needsStreaming() ? "YES" : "no"));
 
@@ -670,45 +1357,84 @@ bool SuperSimpleSamplerProcessor::loadPreloadedSample(const juce::File& sampleFi
 
 const PreloadedSample* SuperSimpleSamplerProcessor::getPreloadedSample(int index) const
 {
-    if (index >= 0 && index < static_cast<int>(preloadedSamples.size()))
-        return &preloadedSamples[static_cast<size_t>(index)];
+    // Message-thread view of the currently published set. The pointer stays
+    // valid as long as the set stays published; callers needing it across an
+    // instrument switch should copy what they need instead.
+    if (auto set = std::atomic_load(&activeSampleSet))
+        if (index >= 0 && index < static_cast<int>(set->samples.size()))
+            return &set->samples[static_cast<size_t>(index)];
     return nullptr;
 }
 
-std::vector<int> SuperSimpleSamplerProcessor::findMatchingPreloadedSamples(int midiNote, int velocity)
+StreamingMetrics::Snapshot SuperSimpleSamplerProcessor::getStreamingMetricsSnapshot() const
 {
-    std::vector<int> matches;
+    StreamingMetrics::Snapshot snapshot;
+    streamingMetrics.readCounters(snapshot);
 
-    for (int i = 0; i < static_cast<int>(preloadedSamples.size()); ++i)
+    // Ring fill levels come from the voices themselves; -1 marks inactive
+    // slots so the report can skip them
+    for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
     {
-        if (preloadedSamples[static_cast<size_t>(i)].matches(midiNote, velocity))
+        const auto& voice = streamingVoices[static_cast<size_t>(i)];
+        if (voice.isActive())
         {
-            matches.push_back(i);
+            ++snapshot.activeVoices;
+            snapshot.ringFillPercent[static_cast<size_t>(i)] =
+                100.0f * static_cast<float>(voice.samplesAvailable())
+                       / static_cast<float>(StreamingConstants::ringBufferFrames);
+        }
+        else
+        {
+            snapshot.ringFillPercent[static_cast<size_t>(i)] = -1.0f;
         }
     }
 
-    return matches;
+    return snapshot;
+}
+
+juce::String SuperSimpleSamplerProcessor::createStreamingHealthReport() const
+{
+    return StreamingMetrics::formatReport(getStreamingMetricsSnapshot());
 }
 
 void SuperSimpleSamplerProcessor::processBlockStreaming(juce::AudioBuffer<float>& buffer,
                                                          juce::MidiBuffer& midiMessages)
 {
-    // Update ADSR for all streaming voices
-    juce::ADSR::Parameters adsrParams;
-    adsrParams.attack = attackParam->load();
-    adsrParams.decay = decayParam->load();
-    adsrParams.sustain = sustainParam->load();
-    adsrParams.release = releaseParam->load();
+    // ADSR settings are applied in processBlock when the epoch is stale
 
-    for (auto& voice : streamingVoices)
+    // Event-sliced rendering, same scheme juce::Synthesiser uses for the RAM
+    // path: render up to each MIDI event's sample position, apply the event,
+    // then continue. Note-ons and -offs land on their exact sample instead of
+    // quantising to the block start, so large host buffers stay usable for
+    // CPU headroom without smearing fast repetitions.
+    const int numSamples = buffer.getNumSamples();
+    int renderedUpTo = 0;
+
+    auto renderSlice = [this, &buffer](int startSample, int sliceLength)
     {
-        voice.setADSRParameters(adsrParams);
-    }
+        if (sliceLength <= 0)
+            return;
+
+        renderPool.renderVoices(streamingVoices.data(),
+                                static_cast<int>(streamingVoices.size()),
+                                buffer, startSample, sliceLength);
+
+        // Preload voices are cheap (short samples, no ring bookkeeping) -
+        // render them serially on the audio thread
+        for (auto& voice : preloadVoices)
+        {
+            if (voice.isActive())
+                voice.renderNextBlock(buffer, startSample, sliceLength);
+        }
+    };
 
-    // Process MIDI messages
     for (const auto metadata : midiMessages)
     {
         auto message = metadata.getMessage();
+        int eventPos = juce::jlimit(0, numSamples, metadata.samplePosition);
+
+        renderSlice(renderedUpTo, eventPos - renderedUpTo);
+        renderedUpTo = std::max(renderedUpTo, eventPos);
 
         if (message.isNoteOn())
         {
@@ -732,20 +1458,16 @@ void SuperSimpleSamplerProcessor::processBlockStreaming(juce::AudioBuffer<float>
                 {
                     voice.setSustainPedal(false);
                 }
+
+                for (auto& voice : preloadVoices)
+                {
+                    voice.setSustainPedal(false);
+                }
             }
         }
     }
 
-    // Render all active streaming voices
-    const int numSamples = buffer.getNumSamples();
-
-    for (auto& voice : streamingVoices)
-    {
-        if (voice.isActive())
-        {
-            voice.renderNextBlock(buffer, 0, numSamples);
-        }
-    }
+    renderSlice(renderedUpTo, numSamples - renderedUpTo);
 }
 
 void SuperSimpleSamplerProcessor::handleNoteOnStreaming(int midiChannel, int midiNote, float velocity)
@@ -754,25 +1476,99 @@ void SuperSimpleSamplerProcessor::handleNoteOnStreaming(int midiChannel, int mid
 
     int intVelocity = static_cast<int>(velocity * 127.0f);
 
-    // Find matching preloaded samples
-    auto matchingSamples = findMatchingPreloadedSamples(midiNote, intVelocity);
+    // Snapshot the published instrument set once for this note-on; every
+    // index below resolves against this snapshot, so a concurrent instrument
+    // switch can never mix old indices with new samples. The raw mirror is
+    // lock-free where atomic_load on the shared_ptr is not; the owning
+    // reference for voice retention comes from shared_from_this, which only
+    // CASes the refcount (the retire list keeps the control block alive
+    // until this callback is provably done).
+    const auto* publishedSet = activeSampleSetPtr.load(std::memory_order_acquire);
+    if (publishedSet == nullptr)
+        return;
+
+    auto set = publishedSet->shared_from_this();
+
+    // Resolve matching preloaded samples through the precomputed index
+    std::array<int, ZoneLookup::maxMatchesPerNote> matchingSamples;
+    int numMatches = set->lookup.findMatches(midiNote, intVelocity,
+                                             matchingSamples.data(),
+                                             static_cast<int>(matchingSamples.size()));
 
-    if (matchingSamples.empty())
+    if (numMatches == 0)
         return;
 
     // Per-note round-robin
-    int& rrCounter = roundRobinCounters[midiNote];
-    int numMatches = static_cast<int>(matchingSamples.size());
+    int& rrCounter = roundRobinCounters[static_cast<size_t>(midiNote & 0x7f)];
     int rrIndex = rrCounter % numMatches;
     int selectedIndex = matchingSamples[static_cast<size_t>(rrIndex)];
 
     rrCounter++;
 
-    const PreloadedSample* selectedSample = &preloadedSamples[static_cast<size_t>(selectedIndex)];
+    // Remember when and how hard this note started, for its release layer
+    noteOnTimesMs[static_cast<size_t>(midiNote & 0x7f)] = juce::Time::getMillisecondCounter();
+    noteOnVelocities[static_cast<size_t>(midiNote & 0x7f)] = velocity;
+
+    const PreloadedSample* selectedSample = &set->samples[static_cast<size_t>(selectedIndex)];
+
+    // Round-robin is deterministic, so the next candidate for this note is
+    // already known - hint the disk thread to warm its first streamed chunk
+    if (numMatches > 1 && diskStreamer != nullptr)
+    {
+        int nextIndex = matchingSamples[static_cast<size_t>(rrCounter % numMatches)];
+        const auto& nextSample = set->samples[static_cast<size_t>(nextIndex)];
+
+        if (nextIndex != selectedIndex && nextSample.needsStreaming())
+            diskStreamer->requestWarm(&nextSample, set);
+    }
+
+    // Record what played as a single packed store; formatted by the editor
+    lastPlayedPacked.store(packLastPlayed(selectedIndex, rrIndex, numMatches, true),
+                           std::memory_order_relaxed);
+    Trace::post(Trace::Event::noteOnStreaming, -1, midiNote,
+                static_cast<int>(velocity * 127.0f), rrIndex, numMatches);
 
-    // Store last played sample name for debug
-    lastPlayedSample = selectedSample->name + " (RR" + juce::String(rrIndex + 1) + "/" + juce::String(numMatches) + ")";
-    debugLog("Streaming note " + juce::String(midiNote) + " -> " + lastPlayedSample);
+    // Samples that fit entirely in their preload never need the streaming
+    // machinery - play them on the lightweight pool and keep the ring-buffer
+    // slots (and the disk scheduler's scan set) for content that streams
+    if (!selectedSample->needsStreaming())
+    {
+        for (auto& voice : preloadVoices)
+        {
+            if (!voice.isActive())
+            {
+                voice.retainSampleSet(set);
+                voice.startVoice(selectedSample, midiNote, velocity, getSampleRate());
+                return;
+            }
+        }
+
+        // Pool exhausted: steal quietest-release / oldest-held, as elsewhere
+        const auto nowMs = juce::Time::getMillisecondCounter();
+        PreloadVoice* best = &preloadVoices[0];
+        float bestScore = std::numeric_limits<float>::max();
+
+        for (auto& voice : preloadVoices)
+        {
+            float score;
+            if (voice.isReleasing())
+                score = voice.getEnvelopeLevel();
+            else
+                score = 2.0f + 1.0f / (1.0f + static_cast<float>(nowMs - voice.getNoteStartMs()));
+
+            if (score < bestScore)
+            {
+                bestScore = score;
+                best = &voice;
+            }
+        }
+
+        best->stopVoice(false);
+        best->retainSampleSet(set);
+        best->startVoice(selectedSample, midiNote, velocity, getSampleRate());
+        best->applyStealFadeIn();
+        return;
+    }
 
     // Get current polyphony setting
     int maxVoices = static_cast<int>(polyphonyParam->load());
@@ -783,22 +1579,52 @@ void SuperSimpleSamplerProcessor::handleNoteOnStreaming(int midiChannel, int mid
     {
         if (!streamingVoices[static_cast<size_t>(i)].isActive())
         {
+            streamingVoices[static_cast<size_t>(i)].retainSampleSet(set);
             streamingVoices[static_cast<size_t>(i)].startVoice(
                 selectedSample, midiNote, velocity, getSampleRate());
             return;
         }
     }
 
-    // No free voice - steal the first one
-    streamingVoices[0].stopVoice(false);
-    streamingVoices[0].startVoice(selectedSample, midiNote, velocity, getSampleRate());
+    // No free voice: steal the least audible one. Voices whose ring has
+    // drained to end of file score lowest (their tail is already on borrowed
+    // time), then releasing voices by envelope level, then held voices by age.
+    {
+        const auto nowMs = juce::Time::getMillisecondCounter();
+        StreamingVoice* best = &streamingVoices[0];
+        float bestScore = std::numeric_limits<float>::max();
+
+        for (int i = 0; i < maxVoices; ++i)
+        {
+            auto& voice = streamingVoices[static_cast<size_t>(i)];
+            float score;
+
+            if (voice.hasReachedEndOfFile())
+                score = -1.0f + voice.getEnvelopeLevel();
+            else if (voice.isReleasing())
+                score = voice.getEnvelopeLevel();
+            else
+                score = 2.0f + 1.0f / (1.0f + static_cast<float>(nowMs - voice.getNoteStartMs()));
+
+            if (score < bestScore)
+            {
+                bestScore = score;
+                best = &voice;
+            }
+        }
+
+        best->stopVoice(false);
+        best->retainSampleSet(set);
+        best->startVoice(selectedSample, midiNote, velocity, getSampleRate());
+        best->applyStealFadeIn();
+    }
 }
 
 void SuperSimpleSamplerProcessor::handleNoteOffStreaming(int midiChannel, int midiNote, float velocity)
 {
     juce::ignoreUnused(midiChannel, velocity);
 
-    // Release all streaming voices playing this note
+    // Release all streaming and preload voices playing this note
     for (auto& voice : streamingVoices)
     {
         if (voice.isActive() && voice.getPlayingNote() == midiNote)
@@ -806,4 +1632,67 @@ void SuperSimpleSamplerProcessor::handleNoteOffStreaming(int midiChannel, int mi
             voice.noteReleasedWithPedal(sustainPedalDown);
         }
     }
+
+    for (auto& voice : preloadVoices)
+    {
+        if (voice.isActive() && voice.getPlayingNote() == midiNote)
+        {
+            voice.noteReleasedWithPedal(sustainPedalDown);
+        }
+    }
+
+    // With the pedal down the damper never falls, so no release sample
+    if (!sustainPedalDown)
+        triggerReleaseSamplesStreaming(midiNote);
+}
+
+void SuperSimpleSamplerProcessor::triggerReleaseSamplesStreaming(int midiNote)
+{
+    float velocity = releaseVelocityFor(midiNote);
+    if (velocity <= 0.0f)
+        return;
+
+    // Same lock-free snapshot as handleNoteOnStreaming: raw mirror plus
+    // shared_from_this, since this also runs on the audio thread
+    const auto* publishedSet = activeSampleSetPtr.load(std::memory_order_acquire);
+    if (publishedSet == nullptr)
+        return;
+
+    auto set = publishedSet->shared_from_this();
+
+    std::array<int, ZoneLookup::maxMatchesPerNote> matchingSamples;
+    int numMatches = set->releaseLookup.findMatches(midiNote, static_cast<int>(velocity * 127.0f),
+                                                    matchingSamples.data(),
+                                                    static_cast<int>(matchingSamples.size()));
+    if (numMatches == 0)
+        return;
+
+    // Pair the release with its note-on's round-robin position (the counter
+    // was advanced at note-on, so step back one)
+    int rrCounter = roundRobinCounters[static_cast<size_t>(midiNote & 0x7f)];
+    int rrIndex = (rrCounter + numMatches - 1) % numMatches;
+    const PreloadedSample* releaseSample = &set->samples[static_cast<size_t>(matchingSamples[static_cast<size_t>(rrIndex)])];
+
+    // Release samples carry a full-size preload precisely so they can play
+    // on the lightweight pool: note-offs raise the audible voice count but
+    // leave the disk thread's working set untouched. An over-long sample
+    // that outgrew even the full preload is dropped (and flagged in debug)
+    // rather than allowed onto the streaming pool.
+    if (releaseSample->needsStreaming())
+    {
+        jassertfalse;  // release sample longer than the maximum preload
+        return;
+    }
+
+    // Free voices only: release layers are ornamental, so under voice
+    // pressure they are dropped rather than stealing a musical note
+    for (auto& voice : preloadVoices)
+    {
+        if (!voice.isActive())
+        {
+            voice.retainSampleSet(set);
+            voice.startVoice(releaseSample, midiNote, velocity, getSampleRate());
+            return;
+        }
+    }
 }
@@ -2,15 +2,21 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_audio_formats/juce_audio_formats.h>
-#include <map>
 #include <array>
+#include <memory>
+#include <thread>
 #include "SampleZone.h"
+#include "ZoneLookup.h"
 #include "InstrumentLoader.h"
 #include "DiskStreaming.h"
+#include "StreamingMetrics.h"
 #include "StreamingVoice.h"
+#include "PreloadVoice.h"
 #include "DiskStreamer.h"
+#include "RenderPool.h"
 
-class SuperSimpleSamplerProcessor : public juce::AudioProcessor
+class SuperSimpleSamplerProcessor : public juce::AudioProcessor,
+                                    private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     SuperSimpleSamplerProcessor();
@@ -60,8 +66,13 @@ public:
     void setSelectedZoneIndex(int index) { selectedZoneIndex = index; }
     const SampleZone* getSelectedZone() const;
 
-    // Round-robin debug info
-    juce::String getLastPlayedSample() const { return lastPlayedSample; }
+    // Round-robin debug info, formatted from the POD the audio thread wrote
+    // (message thread; the audio thread never builds Strings)
+    juce::String getLastPlayedSample() const;
+
+    // False while a state restore is still loading its instrument on the
+    // background loader thread; the processor renders silence until then
+    bool isInstrumentReady() const { return instrumentReady.load(std::memory_order_acquire); }
 
     // Streaming mode controls
     bool isStreamingEnabled() const { return streamingEnabled; }
@@ -70,7 +81,30 @@ public:
 
     // Get preloaded sample info (for streaming mode)
     const PreloadedSample* getPreloadedSample(int index) const;
-    int getNumPreloadedSamples() const { return static_cast<int>(preloadedSamples.size()); }
+    int getNumPreloadedSamples() const
+    {
+        auto set = std::atomic_load(&activeSampleSet);
+        return set != nullptr ? static_cast<int>(set->samples.size()) : 0;
+    }
+
+    // Preload progress (for streaming loads; polled by the editor)
+    int getPreloadProgress() const { return preloadProgress.load(std::memory_order_relaxed); }
+    int getPreloadTotal() const { return preloadTotal.load(std::memory_order_relaxed); }
+
+    // Streaming health metrics (lock-free; polled by the editor's timer)
+    StreamingMetrics::Snapshot getStreamingMetricsSnapshot() const;
+    juce::String createStreamingHealthReport() const;
+    void resetStreamingMetrics() { streamingMetrics.reset(); }
+
+    // Global preload RAM budget (takes effect on the next instrument load)
+    void setPreloadRamBudgetMB(int megabytes)
+    {
+        preloadPolicy.ramBudgetBytes = static_cast<int64_t>(juce::jmax(megabytes, 16)) * 1024 * 1024;
+    }
+    int getPreloadRamBudgetMB() const
+    {
+        return static_cast<int>(preloadPolicy.ramBudgetBytes / (1024 * 1024));
+    }
 
     juce::AudioProcessorValueTreeState& getParameters() { return parameters; }
 
@@ -80,6 +114,15 @@ public:
     public:
         virtual ~Listener() = default;
         virtual void instrumentChanged() = 0;
+
+        // The current instrument is about to be replaced; drop any retained
+        // pointers into its zones now (always called on the message thread,
+        // before the old zones are destroyed)
+        virtual void instrumentAboutToChange() {}
+
+        // The background directory scan finished and getAvailableInstruments
+        // has new contents (always called on the message thread)
+        virtual void instrumentListChanged() {}
     };
 
     void addZoneListener(Listener* listener) { listeners.add(listener); }
@@ -91,10 +134,29 @@ private:
     juce::Synthesiser sampler;
     InstrumentLoader instrumentLoader;
 
+    // Typed view of the sampler's voices, built once at construction so the
+    // per-block paths never need dynamic_cast
+    std::vector<SampleZoneVoice*> samplerVoices;
+
     std::vector<InstrumentInfo> availableInstruments;
     LoadedInstrument currentInstrument;
     int selectedZoneIndex = -1;
 
+    // Background directory scan (results delivered to the message thread)
+    std::thread instrumentScanThread;
+    std::atomic<bool> scanInProgress{false};
+
+    // Asynchronous instrument restore for setStateInformation. While the
+    // loader thread runs, instrumentReady is false and processBlock returns
+    // silence, so the load never races the render path. Voices still
+    // sounding the outgoing instrument are cut by the audio thread itself
+    // when it next observes silenceVoicesForRestore - never by the loader,
+    // which could race a block already inside renderNextBlock.
+    void restoreInstrumentAsync(const juce::File& definitionFile, bool streaming);
+    std::thread stateRestoreThread;
+    std::atomic<bool> instrumentReady{true};
+    std::atomic<bool> silenceVoicesForRestore{false};
+
     juce::ListenerList<Listener> listeners;
 
     // ADSR parameters
@@ -104,20 +166,108 @@ private:
     std::atomic<float>* releaseParam = nullptr;
     std::atomic<float>* gainParam = nullptr;
     std::atomic<float>* polyphonyParam = nullptr;
+    std::atomic<float>* qualityParam = nullptr;
+
+    // Resampling quality last pushed to the voices (audio thread only)
+    int appliedQualityIndex = -1;
+
+    // ==================== Render budget governor ====================
+    // All audio thread only. Block wall times go into a small rolling
+    // window; when the recent worst blocks crowd the callback budget the
+    // governor sheds load deterministically - interpolation quality first,
+    // then the quietest voices - instead of letting the host glitch.
+
+    static constexpr int governorWindowSize = 32;
+
+    // Fraction of the budget the window's worst blocks must cross to
+    // escalate, and stay under everywhere to de-escalate
+    static constexpr double governorEscalateFraction = 0.75;
+    static constexpr double governorRelaxFraction = 0.5;
+
+    std::array<juce::uint32, governorWindowSize> blockTimesUs{};
+    int blockTimeIndex = 0;
+    double blockBudgetUs = 0.0;          // derived from prepareToPlay
+
+    // 0 = full quality, 1 = capped at standard, 2 = capped at live,
+    // 3 = additionally fading the quietest voices while blocks stay hot
+    int governorShedLevel = 0;
+    juce::uint32 lastGovernorStepMs = 0;
+    juce::uint32 lastVoiceShedMs = 0;  // rate limit for level-3 culls
+
+    /** Re-evaluates the shed level from the rolling window (start of block) */
+    void updateRenderGovernor();
+
+    /** Fades out the quietest active voice across all pools */
+    void shedQuietestVoice();
+
+    // Swap a freshly decoded instrument into currentInstrument and rebuild
+    // the sampler around it. Message thread only: the editor reads
+    // currentInstrument.zones freely there, so the swap (which destroys the
+    // old zones and their audio buffers) must never run anywhere else.
+    void applyLoadedInstrument(LoadedInstrument loaded);
 
     void rebuildSampler();
     void updateADSR();
     void notifyListeners();
+    void notifyInstrumentAboutToChange();
+
+    // APVTS listener: bumps the epoch when an envelope knob actually moves
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+    // Parameter-change epoch. The audio thread re-applies ADSR settings to
+    // the voices only when this differs from the epoch it last applied,
+    // instead of pushing parameters to all 64 voices every block.
+    std::atomic<juce::uint32> adsrParamEpoch{1};
+    juce::uint32 appliedAdsrEpoch = 0;  // audio thread only
 
     // Custom MIDI handling for proper velocity/round-robin selection
     void handleNoteOn(int midiChannel, int midiNote, float velocity);
     void handleNoteOff(int midiChannel, int midiNote, float velocity);
     void handleSustainPedal(bool isDown);
-    std::vector<int> findMatchingZones(int midiNote, int velocity);
 
-    // Per-note round-robin counters (like SFZ seq_position)
-    std::map<int, int> roundRobinCounters;  // key = MIDI note, value = current position
-    juce::String lastPlayedSample;
+    // Note-on resolution indices for the RAM path, rebuilt on instrument
+    // load (the streaming path's indices live inside the published sample
+    // set). Release-trigger zones get their own index so they never match a
+    // note-on.
+    ZoneLookup zoneLookup;           // indices into sampler sounds
+    ZoneLookup releaseZoneLookup;    // release-trigger sounds, matched on note-off
+
+    // Per-note round-robin counters (like SFZ seq_position). Fixed array so
+    // the note-on path never touches the allocator the way a map's first
+    // insert for a note would.
+    std::array<int, 128> roundRobinCounters{};
+
+    // When and how hard each note last started (audio thread only). The
+    // release layer derives its velocity from these: the longer a note was
+    // held, the more its string has decayed and the softer the damper falls.
+    std::array<juce::uint32, 128> noteOnTimesMs{};
+    std::array<float, 128> noteOnVelocities{};
+
+    // SFZ-style rt_decay: release-layer attenuation per held second
+    static constexpr float releaseDecayDbPerSecond = 3.0f;
+
+    /** Velocity for a release sample of midiNote, derived from the held
+        duration; returns 0 when no note-on was recorded or the layer has
+        decayed to inaudibility. */
+    float releaseVelocityFor(int midiNote) const;
+
+    // Fire the matching release-trigger sample on note-off
+    void triggerReleaseSamples(int midiNote);           // RAM path
+    void triggerReleaseSamplesStreaming(int midiNote);  // streaming path
+
+    // Last played note-on, packed into one word so the audio thread's store
+    // is a single relaxed atomic and the editor never reads a torn record:
+    // streaming(1) | sampleIndex(16) | rrIndex(8) | numMatches(8).
+    // numMatches is never zero for a real note, so 0 means "nothing yet".
+    std::atomic<juce::uint64> lastPlayedPacked{0};
+
+    static juce::uint64 packLastPlayed(int sampleIndex, int rrIndex, int numMatches, bool streaming)
+    {
+        return (static_cast<juce::uint64>(streaming ? 1 : 0) << 32)
+               | (static_cast<juce::uint64>(sampleIndex & 0xffff) << 16)
+               | (static_cast<juce::uint64>(rrIndex & 0xff) << 8)
+               | static_cast<juce::uint64>(numMatches & 0xff);
+    }
 
     // Sustain pedal state
     bool sustainPedalDown = false;
@@ -128,11 +278,50 @@ private:
     // Streaming voices (used when streamingEnabled is true)
     std::array<StreamingVoice, StreamingConstants::maxStreamingVoices> streamingVoices;
 
+    // Lightweight voices for samples that fit entirely in their preload;
+    // these never touch the ring buffers or the disk thread
+    std::array<PreloadVoice, StreamingConstants::maxPreloadVoices> preloadVoices;
+
     // Background disk streaming thread
     std::unique_ptr<DiskStreamer> diskStreamer;
 
-    // Preloaded samples for streaming mode (replaces full audio data with partial preload)
-    std::vector<PreloadedSample> preloadedSamples;
+    // Spreads per-block voice rendering across cores
+    RenderPool renderPool;
+
+    // Engine-wide health counters, written lock-free by the audio and disk
+    // threads, snapshotted by the editor
+    StreamingMetrics streamingMetrics;
+
+    // The published streaming instrument (RCU). Loader threads build a new
+    // set off to the side and swap it in with one atomic shared_ptr store;
+    // message-thread readers snapshot it with std::atomic_load, never
+    // mutated after publish. The audio thread must not touch this directly:
+    // atomic_load on a shared_ptr goes through a library lock pool on every
+    // mainstream stdlib, and a preempted message-thread reader could then
+    // block a note-on.
+    std::shared_ptr<const PreloadedSampleSet> activeSampleSet;
+
+    // Lock-free mirror of activeSampleSet for the audio thread's per-note
+    // snapshot. Always points at a set kept alive by activeSampleSet or the
+    // retire list below; voices retain the set across blocks via
+    // shared_from_this, which is only refcount CASes.
+    std::atomic<const PreloadedSampleSet*> activeSampleSetPtr{nullptr};
+
+    // Counts processBlock entries (including gated early returns); see
+    // sweepRetiredSets for how it proves audio-thread quiescence
+    std::atomic<juce::uint32> renderBlockCounter{0};
+
+    // Replaced sets awaiting reclamation. The message thread holds the last
+    // reference here so a set's destructor never runs on the audio thread;
+    // sweepRetiredSets frees entries once every voice has let go and the
+    // block counter shows no callback from before the swap is still running.
+    struct RetiredSampleSet
+    {
+        std::shared_ptr<const PreloadedSampleSet> set;
+        juce::uint32 retireBlock = 0;  // renderBlockCounter at retirement
+    };
+    std::vector<RetiredSampleSet> retiredSets;
+    void sweepRetiredSets();
 
     // Audio format manager for streaming (shared with DiskStreamer)
     juce::AudioFormatManager streamingFormatManager;
@@ -142,9 +331,46 @@ private:
     void handleNoteOnStreaming(int midiChannel, int midiNote, float velocity);
     void handleNoteOffStreaming(int midiChannel, int midiNote, float velocity);
 
-    // Load a sample with only preload data (for streaming mode)
-    bool loadPreloadedSample(const juce::File& sampleFile, PreloadedSample& sample);
-    std::vector<int> findMatchingPreloadedSamples(int midiNote, int velocity);
+    // Load a sample with only preload data (for streaming mode).
+    // Takes the format manager explicitly so parallel loader threads can use their own.
+    bool loadPreloadedSample(juce::AudioFormatManager& manager, const juce::File& sampleFile,
+                             PreloadedSample& sample, int preloadBytes);
+
+    // Preload sizing policy (budget is global; base size can be overridden per instrument)
+    PreloadPolicy preloadPolicy;
+
+    // A sample entry parsed from instrument.sss, before its preload has been read
+    struct PendingSampleEntry
+    {
+        juce::File file;
+        int rootNote = 60;
+        int lowNote = 0;
+        int highNote = 127;
+        int lowVelocity = 1;
+        int highVelocity = 127;
+        int preloadBytes = PreloadedSample::preloadSizeBytes;
+
+        // Loop attributes from the XML; negative means "not specified",
+        // letting the WAV smpl chunk supply the loop instead
+        int64_t loopStart = -1;
+        int64_t loopEnd = -1;
+
+        // trigger="release": fires on note-off, preloaded in full
+        bool releaseTrigger = false;
+    };
+
+    // Assign each entry's preload size from the policy, scaled to the RAM budget
+    void computePreloadSizes(std::vector<PendingSampleEntry>& entries) const;
+
+    // Fan the per-sample preload reads out across a worker pool.
+    // Results keep the XML order; failed entries are dropped.
+    void loadPreloadsParallel(const std::vector<PendingSampleEntry>& entries,
+                              std::vector<PreloadedSample>& outSamples);
+
+    // Progress reporting for streaming loads
+    std::atomic<int> preloadProgress{0};
+    std::atomic<int> preloadTotal{0};
 
+    JUCE_DECLARE_WEAK_REFERENCEABLE(SuperSimpleSamplerProcessor)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SuperSimpleSamplerProcessor)
 };
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "DiskStreaming.h"
+#include "Resampler.h"
+
+/**
+ * PreloadVoice plays a sample entirely from its preload buffer.
+ *
+ * Most library content is short release/one-shot material whose whole
+ * waveform fits in the preload, so it never touches the disk thread. Routing
+ * those notes here keeps the heavyweight StreamingVoice slots - each with a
+ * 256KB ring buffer, atomics and a disk registration - reserved for samples
+ * that actually stream, and keeps the disk scheduler's scan set small.
+ *
+ * Audio thread only: no atomics, no ring buffer, no cross-thread state.
+ */
+class PreloadVoice
+{
+public:
+    PreloadVoice() = default;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock)
+    {
+        adsr.setSampleRate(sampleRate);
+
+        // Scratch arrays for the channel-major render kernel
+        auto scratchSize = static_cast<size_t>(std::max(samplesPerBlock, 64));
+        gainScratch.resize(scratchSize);
+        partnerGainScratch.resize(scratchSize);
+        fracScratch.resize(scratchSize);
+        posScratch.resize(scratchSize);
+        partnerPosScratch.resize(scratchSize);
+    }
+
+    void setADSRParameters(const juce::ADSR::Parameters& params)
+    {
+        adsr.setParameters(params);
+    }
+
+    // Set the resampling quality for notes started after this call
+    void setResampleQuality(Resampler::Quality q)
+    {
+        pendingQuality = q;
+    }
+
+    bool isActive() const { return active; }
+    int getPlayingNote() const { return playingNote; }
+    bool isSustainedByPedal() const { return sustainedByPedal; }
+
+    // Steal-selection accessors (same scheme as the other voice classes)
+    bool isReleasing() const { return releasing; }
+    float getEnvelopeLevel() const { return lastEnvelopeLevel; }
+    juce::uint32 getNoteStartMs() const { return noteStartMs; }
+    void applyStealFadeIn() { stealFadeSamples = stealFadeLength; }
+
+    // Governor load shedding: ramp this voice to silence over the next
+    // stealFadeLength samples, then free it
+    void beginShedFadeOut() { if (shedFadeSamples == 0) shedFadeSamples = stealFadeLength; }
+    bool isShedding() const { return shedFadeSamples > 0; }
+
+    // Keep the published instrument set this voice's sample lives in alive
+    // until the voice ends (RCU retirement; call just before startVoice)
+    void retainSampleSet(std::shared_ptr<const PreloadedSampleSet> set) { retainedSet = std::move(set); }
+
+    void startVoice(const PreloadedSample* sample, int midiNote, float vel, double hostSampleRate)
+    {
+        if (sample == nullptr || !sample->isValid())
+            return;
+
+        jassert(!sample->needsStreaming());  // streaming content belongs on a StreamingVoice
+
+        currentSample = sample;
+        playingNote = midiNote;
+        velocity = vel;
+
+        double frequencyOfNote = juce::MidiMessage::getMidiNoteInHertz(midiNote);
+        double frequencyOfRoot = juce::MidiMessage::getMidiNoteInHertz(sample->rootNote);
+        pitchRatio = (frequencyOfNote / frequencyOfRoot) * (sample->sampleRate / hostSampleRate);
+
+        sourceSamplePosition = 0.0;
+        sustainedByPedal = false;
+        releasing = false;
+        shedFadeSamples = 0;
+        lastEnvelopeLevel = 0.0f;
+        noteStartMs = juce::Time::getMillisecondCounter();
+        quality = pendingQuality;
+
+        adsr.noteOn();
+        active = true;
+    }
+
+    void stopVoice(bool allowTailOff)
+    {
+        if (allowTailOff)
+        {
+            adsr.noteOff();
+            releasing = true;
+        }
+        else
+        {
+            reset();
+        }
+    }
+
+    void reset()
+    {
+        active = false;
+        adsr.reset();
+        playingNote = -1;
+        sustainedByPedal = false;
+        releasing = false;
+        shedFadeSamples = 0;
+        lastEnvelopeLevel = 0.0f;
+        currentSample = nullptr;
+        retainedSet.reset();
+    }
+
+    void noteReleasedWithPedal(bool pedalDown)
+    {
+        if (pedalDown)
+        {
+            sustainedByPedal = true;
+        }
+        else
+        {
+            adsr.noteOff();
+            releasing = true;
+        }
+    }
+
+    void setSustainPedal(bool isDown)
+    {
+        if (!isDown && sustainedByPedal)
+        {
+            sustainedByPedal = false;
+            adsr.noteOff();
+            releasing = true;
+        }
+    }
+
+    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+    {
+        if (!active || currentSample == nullptr)
+            return;
+
+        // Grow scratch if the host delivers a bigger block than it prepared us for
+        if (static_cast<size_t>(numSamples) > posScratch.size())
+        {
+            jassertfalse;  // host exceeded samplesPerBlock from prepareToPlay
+            gainScratch.resize(static_cast<size_t>(numSamples));
+            partnerGainScratch.resize(static_cast<size_t>(numSamples));
+            fracScratch.resize(static_cast<size_t>(numSamples));
+            posScratch.resize(static_cast<size_t>(numSamples));
+            partnerPosScratch.resize(static_cast<size_t>(numSamples));
+        }
+
+        const auto& preload = currentSample->preloadBuffer;
+        const int totalFrames = preload.getNumSamples();
+        const int numOutputChannels = outputBuffer.getNumChannels();
+        const int numSourceChannels = preload.getNumChannels();
+
+        // Sustain loop (fully contained in the preload for non-streaming
+        // samples); crossfades equal-power with the lead-in to the loop start
+        const bool looping = currentSample->hasLoop();
+        const int loopStart = static_cast<int>(juce::jlimit<int64_t>(0, totalFrames, currentSample->loopStartFrame));
+        const int loopEnd = static_cast<int>(juce::jlimit<int64_t>(loopStart, totalFrames, currentSample->loopEndFrame));
+        const int loopLength = loopEnd - loopStart;
+        const int crossfade = (looping && loopLength > 0)
+                                  ? std::min({ loopCrossfadeLength, loopStart, loopLength }) : 0;
+
+        // ---- Resolve block boundaries up front so the channel loops are tight ----
+
+        if (!looping && sourceSamplePosition >= static_cast<double>(totalFrames))
+        {
+            reset();
+            return;
+        }
+
+        int framesToRender = numSamples;
+        if (!looping)
+        {
+            double remaining = static_cast<double>(totalFrames) - sourceSamplePosition;
+            int bySource = static_cast<int>(std::ceil(remaining / pitchRatio));
+            framesToRender = std::min(framesToRender, std::max(bySource, 0));
+        }
+
+        if (framesToRender <= 0)
+        {
+            reset();
+            return;
+        }
+
+        // ---- Envelope and gain as a per-block ramp ----
+
+        bool envelopeEnded = false;
+        int envFrames = framesToRender;
+        for (int i = 0; i < framesToRender; ++i)
+        {
+            float env = adsr.getNextSample();
+            lastEnvelopeLevel = env;
+            gainScratch[static_cast<size_t>(i)] = env * velocity;
+            if (!adsr.isActive())
+            {
+                envFrames = i + 1;
+                envelopeEnded = true;
+                break;
+            }
+        }
+        framesToRender = envFrames;
+
+        if (stealFadeSamples > 0)
+        {
+            for (int i = 0; i < framesToRender && stealFadeSamples > 0; ++i)
+            {
+                gainScratch[static_cast<size_t>(i)] *= static_cast<float>(stealFadeLength - stealFadeSamples)
+                                                       / static_cast<float>(stealFadeLength);
+                stealFadeSamples--;
+            }
+        }
+
+        // Governor shed: ramp down to silence, then free the voice
+        bool shedFadeEnded = false;
+        if (shedFadeSamples > 0)
+        {
+            for (int i = 0; i < framesToRender; ++i)
+            {
+                gainScratch[static_cast<size_t>(i)] *= static_cast<float>(shedFadeSamples)
+                                                       / static_cast<float>(stealFadeLength);
+                if (--shedFadeSamples == 0)
+                {
+                    framesToRender = i + 1;
+                    shedFadeEnded = true;
+                    break;
+                }
+            }
+        }
+
+        // ---- Positions, fractions and loop-crossfade gains, computed once ----
+        // Inside the crossfade window gainScratch carries the primary (cos)
+        // side and partnerGainScratch the lead-in (sin) side, zero elsewhere
+
+        double pos = sourceSamplePosition;
+        int crossfadeFirst = framesToRender, crossfadeLast = 0;
+
+        for (int i = 0; i < framesToRender; ++i)
+        {
+            while (looping && loopLength > 0 && pos >= static_cast<double>(loopEnd))
+                pos -= loopLength;
+
+            int p = static_cast<int>(pos);
+            posScratch[static_cast<size_t>(i)] = p;
+            fracScratch[static_cast<size_t>(i)] = static_cast<float>(pos - static_cast<double>(p));
+            partnerGainScratch[static_cast<size_t>(i)] = 0.0f;
+
+            if (crossfade > 0 && pos >= static_cast<double>(loopEnd - crossfade))
+            {
+                float t = static_cast<float>((pos - (loopEnd - crossfade)) / crossfade);
+                partnerGainScratch[static_cast<size_t>(i)] = gainScratch[static_cast<size_t>(i)]
+                                                             * std::sin(t * juce::MathConstants<float>::halfPi);
+                gainScratch[static_cast<size_t>(i)] *= std::cos(t * juce::MathConstants<float>::halfPi);
+                partnerPosScratch[static_cast<size_t>(i)] = p - loopLength;
+                crossfadeFirst = std::min(crossfadeFirst, i);
+                crossfadeLast = i + 1;
+            }
+
+            pos += pitchRatio;
+        }
+        sourceSamplePosition = pos;
+
+        const float* sincTable = Resampler::getSincTable();
+
+        // ---- One tight loop per channel, plus a bounded partner pass ----
+
+        for (int ch = 0; ch < numOutputChannels; ++ch)
+        {
+            const float* src = preload.getReadPointer(std::min(ch, numSourceChannels - 1));
+            float* out = outputBuffer.getWritePointer(ch, startSample);
+
+            // The kernel's outer taps clamp at the preload edges
+            auto interpolateAt = [&](int base, float frac)
+            {
+                return Resampler::interpolate(quality, sincTable,
+                    [src, base, totalFrames](int tap)
+                    {
+                        return src[juce::jlimit(0, totalFrames - 1, base + tap)];
+                    },
+                    frac);
+            };
+
+            for (int i = 0; i < framesToRender; ++i)
+                out[i] += interpolateAt(posScratch[static_cast<size_t>(i)],
+                                        fracScratch[static_cast<size_t>(i)])
+                          * gainScratch[static_cast<size_t>(i)];
+
+            for (int i = crossfadeFirst; i < crossfadeLast; ++i)
+            {
+                float partnerGain = partnerGainScratch[static_cast<size_t>(i)];
+                if (partnerGain > 0.0f)
+                    out[i] += interpolateAt(partnerPosScratch[static_cast<size_t>(i)],
+                                            fracScratch[static_cast<size_t>(i)])
+                              * partnerGain;
+            }
+        }
+
+        // ---- Advance state once per block ----
+
+        if (envelopeEnded || shedFadeEnded
+            || (!looping && sourceSamplePosition >= static_cast<double>(totalFrames)))
+            reset();
+    }
+
+private:
+    const PreloadedSample* currentSample = nullptr;
+
+    // Reference on the instrument set currentSample lives in; the
+    // processor's retire list holds the last reference, so dropping this on
+    // the audio thread never destroys the set here
+    std::shared_ptr<const PreloadedSampleSet> retainedSet;
+
+    double sourceSamplePosition = 0.0;
+    double pitchRatio = 1.0;
+    float velocity = 0.0f;
+    juce::ADSR adsr;
+
+    bool active = false;
+    int playingNote = -1;
+    bool sustainedByPedal = false;
+
+    // Sustain-loop crossfade length in source frames
+    static constexpr int loopCrossfadeLength = 1024;
+
+    // Resampling kernel, latched from pendingQuality at note start
+    Resampler::Quality pendingQuality = Resampler::Quality::standard;
+    Resampler::Quality quality = Resampler::Quality::standard;
+
+    // Steal-selection state
+    static constexpr int stealFadeLength = 64;
+    bool releasing = false;
+    float lastEnvelopeLevel = 0.0f;
+    juce::uint32 noteStartMs = 0;
+    int stealFadeSamples = 0;
+    int shedFadeSamples = 0;  // governor fade-out; counts down to the cull
+
+    // Per-block scratch (sized in prepareToPlay) for the channel-major
+    // render kernel: positions, fractions and the gain ramp are resolved up
+    // front, then each channel is one tight contiguous loop
+    std::vector<float> gainScratch;
+    std::vector<float> partnerGainScratch;
+    std::vector<float> fracScratch;
+    std::vector<int> posScratch;
+    std::vector<int> partnerPosScratch;
+};
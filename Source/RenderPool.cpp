@@ -0,0 +1,172 @@
+#include "RenderPool.h"
+
+class RenderPool::Worker : public juce::Thread
+{
+public:
+    Worker(RenderPool& ownerPool, int workerIndex)
+        : juce::Thread("RenderWorker " + juce::String(workerIndex)),
+          pool(ownerPool)
+    {
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wakeup.signal();
+        stopThread(1000);
+    }
+
+    void prepare(int samplesPerBlock)
+    {
+        accumBuffer.setSize(2, samplesPerBlock, false, false, true);
+        accumBuffer.clear();
+    }
+
+    void startJob()
+    {
+        wakeup.signal();
+    }
+
+    juce::AudioBuffer<float> accumBuffer;
+    bool renderedAnything = false;  // valid after workersRemaining hits zero
+
+private:
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            wakeup.wait(-1);
+
+            if (threadShouldExit())
+                break;
+
+            // Only the slice being rendered needs clearing - voices add
+            accumBuffer.clear(pool.jobStartSample, pool.jobNumSamples);
+
+            renderedAnything = false;
+            pool.participate(accumBuffer, renderedAnything);
+
+            // Release ordering publishes the accumulation buffer contents
+            // to the audio thread's acquire load of the counter
+            pool.workersRemaining.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    RenderPool& pool;
+    juce::WaitableEvent wakeup;
+};
+
+RenderPool::RenderPool() = default;
+
+RenderPool::~RenderPool()
+{
+    releaseResources();
+}
+
+void RenderPool::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    juce::ignoreUnused(sampleRate);
+
+    releaseResources();
+
+    int numWorkers = juce::jlimit(0, maxWorkers, juce::SystemStats::getNumCpus() - 1);
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto worker = std::make_unique<Worker>(*this, i);
+        worker->prepare(samplesPerBlock);
+        worker->startThread(juce::Thread::Priority::highest);
+        workers.push_back(std::move(worker));
+    }
+
+    prepared = true;
+}
+
+void RenderPool::releaseResources()
+{
+    workers.clear();  // Worker destructor joins each thread
+    prepared = false;
+}
+
+void RenderPool::participate(juce::AudioBuffer<float>& accumBuffer, bool& renderedAnything)
+{
+    for (;;)
+    {
+        int index = nextVoice.fetch_add(1, std::memory_order_relaxed);
+        if (index >= jobNumVoices)
+            return;
+
+        auto& voice = jobVoices[index];
+        if (voice.isActive())
+        {
+            voice.renderNextBlock(accumBuffer, jobStartSample, jobNumSamples);
+            renderedAnything = true;
+        }
+    }
+}
+
+void RenderPool::renderVoices(StreamingVoice* voices, int numVoices,
+                              juce::AudioBuffer<float>& outputBuffer,
+                              int startSample, int numSamples)
+{
+    if (numSamples <= 0 || numVoices <= 0)
+        return;
+
+    int activeVoices = 0;
+    for (int i = 0; i < numVoices; ++i)
+        if (voices[i].isActive())
+            ++activeVoices;
+
+    if (activeVoices == 0)
+        return;
+
+    // Serial path: pool not running, too few voices to pay the fan-out, or
+    // the slice ends past the prepared accumulators. Event-split slices
+    // start at an offset, so the end of the slice is what must fit - an
+    // oversized host block with startSample > 0 can pass a numSamples-only
+    // check and still run the clear/addFrom off the end of the buffers.
+    if (!prepared || workers.empty() || activeVoices < minVoicesForParallel
+        || startSample + numSamples > workers.front()->accumBuffer.getNumSamples())
+    {
+        for (int i = 0; i < numVoices; ++i)
+            if (voices[i].isActive())
+                voices[i].renderNextBlock(outputBuffer, startSample, numSamples);
+        return;
+    }
+
+    // Publish the job, then wake the workers
+    jobVoices = voices;
+    jobNumVoices = numVoices;
+    jobStartSample = startSample;
+    jobNumSamples = numSamples;
+    nextVoice.store(0, std::memory_order_relaxed);
+    workersRemaining.store(static_cast<int>(workers.size()), std::memory_order_release);
+
+    for (auto& worker : workers)
+        worker->startJob();
+
+    // The audio thread renders straight into the output - it is one of the
+    // accumulators, so its share needs no extra summing pass
+    bool audioThreadRendered = false;
+    participate(outputBuffer, audioThreadRendered);
+
+    // Lock-free completion: spin until every worker has signed off. Workers
+    // run at highest priority on their own cores, so the wait is bounded by
+    // the slowest single voice, not by a scheduler round-trip.
+    while (workersRemaining.load(std::memory_order_acquire) != 0)
+        ;
+
+    // Sum the worker accumulators into the output
+    int numChannels = outputBuffer.getNumChannels();
+    for (auto& worker : workers)
+    {
+        if (!worker->renderedAnything)
+            continue;
+
+        for (int ch = 0; ch < std::min(numChannels, worker->accumBuffer.getNumChannels()); ++ch)
+        {
+            outputBuffer.addFrom(ch, startSample, worker->accumBuffer,
+                                 ch, startSample, numSamples);
+        }
+    }
+}
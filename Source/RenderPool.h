@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "StreamingVoice.h"
+
+/**
+ * RenderPool spreads the per-block voice rendering across CPU cores.
+ *
+ * Each block the audio thread publishes a job (the voice array and the slice
+ * to render), wakes the workers and then participates itself. Voices are
+ * handed out one at a time through an atomic index, which gives the same
+ * load balancing as work stealing without per-thread deques: a worker that
+ * draws a cheap voice simply comes back for the next one. Every thread
+ * renders into its own accumulation buffer so no two threads ever touch the
+ * same output samples; the audio thread sums the worker buffers into the
+ * output once the lock-free completion counter reaches zero.
+ *
+ * Blocks with only a few active voices are rendered serially - the wakeup
+ * and summing overhead outweighs the parallelism below that point.
+ */
+class RenderPool
+{
+public:
+    RenderPool();
+    ~RenderPool();
+
+    // Sizes the accumulation buffers and starts the workers. Safe to call
+    // again on a prepared pool (re-prepare for a new block size).
+    void prepareToPlay(double sampleRate, int samplesPerBlock);
+
+    // Stops the workers; rendering falls back to serial until re-prepared
+    void releaseResources();
+
+    // Renders all active voices in [startSample, startSample + numSamples)
+    // additively into outputBuffer. Called on the audio thread only.
+    void renderVoices(StreamingVoice* voices, int numVoices,
+                      juce::AudioBuffer<float>& outputBuffer,
+                      int startSample, int numSamples);
+
+private:
+    // Below this many active voices the fan-out costs more than it saves
+    static constexpr int minVoicesForParallel = 8;
+
+    // The audio thread is a renderer too, so cap workers at cores - 1
+    static constexpr int maxWorkers = 7;
+
+    class Worker;
+
+    // Shared job state, published by the audio thread before the wakeup
+    StreamingVoice* jobVoices = nullptr;
+    int jobNumVoices = 0;
+    int jobStartSample = 0;
+    int jobNumSamples = 0;
+
+    std::atomic<int> nextVoice{0};        // atomic handout of voice indices
+    std::atomic<int> workersRemaining{0}; // completion countdown
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    bool prepared = false;
+
+    // Renders handed-out voices into the given buffer until the job is empty
+    void participate(juce::AudioBuffer<float>& accumBuffer, bool& renderedAnything);
+
+    friend class Worker;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderPool)
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cmath>
+
+/**
+ * Resampler holds the interpolation kernels shared by every voice class.
+ *
+ * Three qualities trade CPU for fidelity, chosen by the "quality" processor
+ * parameter and latched per voice at note start (so a kernel never switches
+ * mid-note):
+ *  - live:     2-point linear - cheapest, but aliases audibly on deep
+ *              pitch-down, which is this sampler's whole mapping model
+ *  - standard: 4-point Catmull-Rom - closed form, no tables
+ *  - high:     8-tap windowed sinc, precomputed as a polyphase coefficient
+ *              table so each output frame costs eight FMAs and a row lookup
+ *
+ * Every kernel is centred on the integer output position: quality q reads
+ * framesBehind(q) frames before pos0 and framesAhead(q) after it. Callers
+ * keep those taps readable - clamping at buffer edges for RAM playback, or
+ * holding the ring read position back for streaming.
+ */
+namespace Resampler
+{
+    enum class Quality
+    {
+        live = 0,      // 2-point linear
+        standard = 1,  // 4-point Catmull-Rom
+        high = 2       // 8-tap windowed sinc
+    };
+
+    constexpr int sincTaps = 8;
+    constexpr int sincPhases = 256;
+
+    /** Frames a kernel reads before the integer output position */
+    constexpr int framesBehind(Quality q)
+    {
+        return q == Quality::high ? 3 : (q == Quality::standard ? 1 : 0);
+    }
+
+    /** Frames a kernel reads after the integer output position */
+    constexpr int framesAhead(Quality q)
+    {
+        return q == Quality::high ? 4 : (q == Quality::standard ? 2 : 1);
+    }
+
+    /** Maps the "quality" parameter's raw choice index onto a Quality */
+    inline Quality fromParameterValue(float value)
+    {
+        return static_cast<Quality>(juce::jlimit(0, 2, static_cast<int>(value + 0.5f)));
+    }
+
+    /** The polyphase sinc table: sincPhases rows of sincTaps coefficients.
+        Row p holds a Hann-windowed sinc sampled at (tap - 3 - p/sincPhases),
+        normalised to unity DC gain. Built on first call - call once from
+        prepareToPlay so the build never lands on the audio thread. */
+    inline const float* getSincTable()
+    {
+        static const auto table = []
+        {
+            std::array<float, sincPhases * sincTaps> t{};
+            constexpr double pi = juce::MathConstants<double>::pi;
+            constexpr double halfWidth = sincTaps / 2;
+
+            for (int phase = 0; phase < sincPhases; ++phase)
+            {
+                double frac = static_cast<double>(phase) / sincPhases;
+                double sum = 0.0;
+                auto* row = t.data() + phase * sincTaps;
+
+                for (int tap = 0; tap < sincTaps; ++tap)
+                {
+                    double x = static_cast<double>(tap - framesBehind(Quality::high)) - frac;
+                    double sinc = (x == 0.0) ? 1.0 : std::sin(pi * x) / (pi * x);
+                    double window = 0.5 * (1.0 + std::cos(pi * x / halfWidth));
+                    row[tap] = static_cast<float>(sinc * window);
+                    sum += sinc * window;
+                }
+
+                for (int tap = 0; tap < sincTaps; ++tap)
+                    row[tap] = static_cast<float>(row[tap] / sum);
+            }
+
+            return t;
+        }();
+
+        return table.data();
+    }
+
+    /** The coefficient row for a given interpolation fraction (0..1) */
+    inline const float* sincRowForFraction(const float* table, float frac)
+    {
+        auto phase = juce::jlimit(0, sincPhases - 1, static_cast<int>(frac * sincPhases));
+        return table + phase * sincTaps;
+    }
+
+    /** 4-point Catmull-Rom: sm1..s2 are the samples at pos0-1 .. pos0+2 */
+    inline float catmullRom(float sm1, float s0, float s1, float s2, float frac)
+    {
+        float c1 = 0.5f * (s1 - sm1);
+        float c2 = sm1 - 2.5f * s0 + 2.0f * s1 - 0.5f * s2;
+        float c3 = 0.5f * (s2 - sm1) + 1.5f * (s0 - s1);
+        return ((c3 * frac + c2) * frac + c1) * frac + s0;
+    }
+
+    /** Generic kernel dispatch for per-sample render loops. fetch(i) must
+        return the source sample at pos0 + i for i in
+        [-framesBehind(q), framesAhead(q)]. The switch is loop-invariant per
+        block, so the branch predicts perfectly in a render loop. */
+    template <typename Fetch>
+    inline float interpolate(Quality q, const float* sincTable, Fetch&& fetch, float frac)
+    {
+        switch (q)
+        {
+            case Quality::standard:
+                return catmullRom(fetch(-1), fetch(0), fetch(1), fetch(2), frac);
+
+            case Quality::high:
+            {
+                const float* row = sincRowForFraction(sincTable, frac);
+                float acc = 0.0f;
+                for (int tap = 0; tap < sincTaps; ++tap)
+                    acc += row[tap] * fetch(tap - framesBehind(Quality::high));
+                return acc;
+            }
+
+            case Quality::live:
+            default:
+            {
+                float s0 = fetch(0);
+                return s0 + frac * (fetch(1) - s0);
+            }
+        }
+    }
+}
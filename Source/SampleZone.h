@@ -1,6 +1,9 @@
 #pragma once
 
 #include <juce_audio_formats/juce_audio_formats.h>
+#include <cmath>
+#include <vector>
+#include "Resampler.h"
 
 struct SampleZone
 {
@@ -14,8 +17,18 @@ struct SampleZone
     int lowVelocity = 1;    // Lowest velocity that triggers this sample
     int highVelocity = 127; // Highest velocity that triggers this sample
 
+    // Fires on note-off instead of note-on (trigger="release" in the .sss)
+    bool releaseTrigger = false;
+
+    // Sustain loop in source frames (from .sss attributes or WAV smpl chunk);
+    // loopEnd <= loopStart means no loop
+    int loopStart = 0;
+    int loopEnd = 0;
+
     bool isValid() const { return audioData.getNumSamples() > 0; }
 
+    bool hasLoop() const { return loopEnd > loopStart; }
+
     bool containsNote(int midiNote) const
     {
         return midiNote >= lowNote && midiNote <= highNote;
@@ -81,6 +94,44 @@ public:
         return sustainedByPedal;
     }
 
+    // Is this voice in its release phase? (steal candidates prefer these)
+    bool isReleasing() const
+    {
+        return releasing;
+    }
+
+    // Envelope level at the end of the last rendered block (0..1)
+    float getEnvelopeLevel() const
+    {
+        return lastEnvelopeLevel;
+    }
+
+    // When this voice's current note started (millisecond counter)
+    juce::uint32 getNoteStartMs() const
+    {
+        return noteStartMs;
+    }
+
+    // Ramp the next few samples up from silence; called after a steal so
+    // the hard cut of the previous note doesn't click
+    void applyStealFadeIn()
+    {
+        stealFadeSamples = stealFadeLength;
+    }
+
+    // Governor load shedding: ramp this voice to silence over the next
+    // stealFadeLength samples, then free it
+    void beginShedFadeOut()
+    {
+        if (shedFadeSamples == 0)
+            shedFadeSamples = stealFadeLength;
+    }
+
+    bool isShedding() const
+    {
+        return shedFadeSamples > 0;
+    }
+
     void setSustainPedal(bool isDown)
     {
         if (!isDown && sustainedByPedal)
@@ -88,6 +139,7 @@ public:
             // Pedal released - stop the sustained note
             sustainedByPedal = false;
             adsr.noteOff();
+            releasing = true;
         }
     }
 
@@ -105,6 +157,11 @@ public:
             playing = true;
             playingNote = midiNoteNumber;
             sustainedByPedal = false;
+            releasing = false;
+            shedFadeSamples = 0;
+            lastEnvelopeLevel = 0.0f;
+            noteStartMs = juce::Time::getMillisecondCounter();
+            quality = pendingQuality;
 
             // Calculate pitch ratio based on root note
             double frequencyOfNote = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
@@ -125,6 +182,7 @@ public:
         if (allowTailOff)
         {
             adsr.noteOff();
+            releasing = true;
         }
         else
         {
@@ -133,6 +191,8 @@ public:
             playing = false;
             playingNote = -1;
             sustainedByPedal = false;
+            releasing = false;
+            shedFadeSamples = 0;
         }
     }
 
@@ -148,6 +208,7 @@ public:
         {
             // No pedal - release normally
             adsr.noteOff();
+            releasing = true;
         }
     }
 
@@ -159,9 +220,24 @@ public:
         adsr.setParameters(params);
     }
 
-    void prepareToPlay(double sampleRate, int)
+    // Set the resampling quality for notes started after this call
+    // (running notes keep their kernel so the timbre never steps mid-note)
+    void setResampleQuality(Resampler::Quality q)
+    {
+        pendingQuality = q;
+    }
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock)
     {
         adsr.setSampleRate(sampleRate);
+
+        // Scratch arrays for the channel-major render kernel
+        auto scratchSize = static_cast<size_t>(std::max(samplesPerBlock, 64));
+        gainScratch.resize(scratchSize);
+        partnerGainScratch.resize(scratchSize);
+        fracScratch.resize(scratchSize);
+        posScratch.resize(scratchSize);
+        partnerPosScratch.resize(scratchSize);
     }
 
     void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override
@@ -169,67 +245,186 @@ public:
         if (!playing || currentZone == nullptr || !currentZone->isValid())
             return;
 
+        // Grow scratch if the host delivers a bigger block than it prepared us for
+        if (static_cast<size_t>(numSamples) > posScratch.size())
+        {
+            jassertfalse;  // host exceeded samplesPerBlock from prepareToPlay
+            gainScratch.resize(static_cast<size_t>(numSamples));
+            partnerGainScratch.resize(static_cast<size_t>(numSamples));
+            fracScratch.resize(static_cast<size_t>(numSamples));
+            posScratch.resize(static_cast<size_t>(numSamples));
+            partnerPosScratch.resize(static_cast<size_t>(numSamples));
+        }
+
         const auto& audioData = currentZone->audioData;
         const int totalSamples = audioData.getNumSamples();
-        const int numChannels = std::min(audioData.getNumChannels(), outputBuffer.getNumChannels());
+        const int numOutputChannels = outputBuffer.getNumChannels();
+        const int numSourceChannels = audioData.getNumChannels();
+
+        // Sustain loop setup: the crossfade blends the loop tail with the
+        // audio just before the loop start, so it needs that much lead-in
+        const bool looping = currentZone->hasLoop();
+        const int loopStart = juce::jlimit(0, totalSamples, currentZone->loopStart);
+        const int loopEnd = juce::jlimit(loopStart, totalSamples, currentZone->loopEnd);
+        const int loopLength = loopEnd - loopStart;
+        const int crossfade = looping ? std::min({ loopCrossfadeLength, loopStart, loopLength }) : 0;
+
+        // ---- Resolve block boundaries up front so the channel loops are tight ----
 
-        for (int sample = 0; sample < numSamples; ++sample)
+        if (!looping && samplePosition >= static_cast<double>(totalSamples))
         {
-            if (samplePosition >= totalSamples)
+            stopPlayback();
+            return;
+        }
+
+        int framesToRender = numSamples;
+        if (!looping)
+        {
+            double remaining = static_cast<double>(totalSamples) - samplePosition;
+            int bySource = static_cast<int>(std::ceil(remaining / pitchRatio));
+            framesToRender = std::min(framesToRender, std::max(bySource, 0));
+        }
+
+        if (framesToRender <= 0)
+        {
+            stopPlayback();
+            return;
+        }
+
+        // ---- Envelope and gain as a per-block ramp ----
+
+        bool envelopeEnded = false;
+        int envFrames = framesToRender;
+        for (int i = 0; i < framesToRender; ++i)
+        {
+            float env = adsr.getNextSample();
+            lastEnvelopeLevel = env;
+            gainScratch[static_cast<size_t>(i)] = env * level;
+            if (!adsr.isActive())
             {
-                clearCurrentNote();
-                adsr.reset();
-                playing = false;
-                playingNote = -1;
-                sustainedByPedal = false;
+                envFrames = i + 1;
+                envelopeEnded = true;
                 break;
             }
+        }
+        framesToRender = envFrames;
 
-            float envelopeValue = adsr.getNextSample();
+        // Short ramp up after a steal to mask the previous note's hard cut
+        if (stealFadeSamples > 0)
+        {
+            for (int i = 0; i < framesToRender && stealFadeSamples > 0; ++i)
+            {
+                gainScratch[static_cast<size_t>(i)] *= static_cast<float>(stealFadeLength - stealFadeSamples)
+                                                       / static_cast<float>(stealFadeLength);
+                stealFadeSamples--;
+            }
+        }
 
-            if (!adsr.isActive())
+        // Governor shed: ramp down to silence, then free the voice
+        bool shedFadeEnded = false;
+        if (shedFadeSamples > 0)
+        {
+            for (int i = 0; i < framesToRender; ++i)
             {
-                clearCurrentNote();
-                playing = false;
-                playingNote = -1;
-                sustainedByPedal = false;
-                break;
+                gainScratch[static_cast<size_t>(i)] *= static_cast<float>(shedFadeSamples)
+                                                       / static_cast<float>(stealFadeLength);
+                if (--shedFadeSamples == 0)
+                {
+                    framesToRender = i + 1;
+                    shedFadeEnded = true;
+                    break;
+                }
             }
+        }
 
-            // Linear interpolation for smooth playback
-            int pos0 = static_cast<int>(samplePosition);
-            int pos1 = pos0 + 1;
-            float frac = static_cast<float>(samplePosition - pos0);
+        // ---- Positions, fractions and loop-crossfade gains, computed once ----
+        // Inside the crossfade window the equal-power pair is folded into the
+        // gain arrays: gainScratch carries the primary (cos) side and
+        // partnerGainScratch the lead-in (sin) side, zero outside the window.
 
-            if (pos1 >= totalSamples)
-                pos1 = pos0;
+        double pos = samplePosition;
+        int crossfadeFirst = framesToRender, crossfadeLast = 0;
 
-            for (int ch = 0; ch < numChannels; ++ch)
-            {
-                const float* data = audioData.getReadPointer(ch);
-                float sample0 = data[pos0];
-                float sample1 = data[pos1];
-                float interpolated = sample0 + frac * (sample1 - sample0);
+        for (int i = 0; i < framesToRender; ++i)
+        {
+            while (looping && loopLength > 0 && pos >= static_cast<double>(loopEnd))
+                pos -= loopLength;
 
-                outputBuffer.addSample(ch, startSample + sample, interpolated * level * envelopeValue);
-            }
+            int p = static_cast<int>(pos);
+            posScratch[static_cast<size_t>(i)] = p;
+            fracScratch[static_cast<size_t>(i)] = static_cast<float>(pos - static_cast<double>(p));
+            partnerGainScratch[static_cast<size_t>(i)] = 0.0f;
 
-            // For mono samples, copy to both channels
-            if (numChannels == 1 && outputBuffer.getNumChannels() > 1)
+            if (crossfade > 0 && pos >= static_cast<double>(loopEnd - crossfade))
             {
-                const float* data = audioData.getReadPointer(0);
-                float sample0 = data[pos0];
-                float sample1 = data[pos1];
-                float interpolated = sample0 + frac * (sample1 - sample0);
-
-                outputBuffer.addSample(1, startSample + sample, interpolated * level * envelopeValue);
+                float t = static_cast<float>((pos - (loopEnd - crossfade)) / crossfade);
+                partnerGainScratch[static_cast<size_t>(i)] = gainScratch[static_cast<size_t>(i)]
+                                                             * std::sin(t * juce::MathConstants<float>::halfPi);
+                gainScratch[static_cast<size_t>(i)] *= std::cos(t * juce::MathConstants<float>::halfPi);
+                partnerPosScratch[static_cast<size_t>(i)] = p - loopLength;
+                crossfadeFirst = std::min(crossfadeFirst, i);
+                crossfadeLast = i + 1;
             }
 
-            samplePosition += pitchRatio;
+            pos += pitchRatio;
         }
+        samplePosition = pos;
+
+        const float* sincTable = Resampler::getSincTable();
+
+        // ---- One tight loop per channel, plus a bounded partner pass ----
+
+        for (int ch = 0; ch < numOutputChannels; ++ch)
+        {
+            const float* src = audioData.getReadPointer(std::min(ch, numSourceChannels - 1));
+            float* out = outputBuffer.getWritePointer(ch, startSample);
+
+            // The kernel's outer taps clamp at the buffer edges
+            auto interpolateAt = [&](int base, float frac)
+            {
+                return Resampler::interpolate(quality, sincTable,
+                    [src, base, totalSamples](int tap)
+                    {
+                        return src[juce::jlimit(0, totalSamples - 1, base + tap)];
+                    },
+                    frac);
+            };
+
+            for (int i = 0; i < framesToRender; ++i)
+                out[i] += interpolateAt(posScratch[static_cast<size_t>(i)],
+                                        fracScratch[static_cast<size_t>(i)])
+                          * gainScratch[static_cast<size_t>(i)];
+
+            for (int i = crossfadeFirst; i < crossfadeLast; ++i)
+            {
+                float partnerGain = partnerGainScratch[static_cast<size_t>(i)];
+                if (partnerGain > 0.0f)
+                    out[i] += interpolateAt(partnerPosScratch[static_cast<size_t>(i)],
+                                            fracScratch[static_cast<size_t>(i)])
+                              * partnerGain;
+            }
+        }
+
+        // ---- Advance state once per block ----
+
+        if (envelopeEnded || shedFadeEnded
+            || (!looping && samplePosition >= static_cast<double>(totalSamples)))
+            stopPlayback();
     }
 
 private:
+    // Stop this voice and clear all note state (end of sample or envelope)
+    void stopPlayback()
+    {
+        clearCurrentNote();
+        adsr.reset();
+        playing = false;
+        playingNote = -1;
+        sustainedByPedal = false;
+        releasing = false;
+        shedFadeSamples = 0;
+    }
+
     const SampleZone* currentZone = nullptr;
     double samplePosition = 0.0;
     double pitchRatio = 1.0;
@@ -239,4 +434,29 @@ private:
     bool playing = false;
     int playingNote = -1;
     bool sustainedByPedal = false;
+
+    // Sustain-loop crossfade length in source frames
+    static constexpr int loopCrossfadeLength = 1024;
+
+    // Resampling kernel: pendingQuality tracks the parameter, quality is
+    // latched from it at note start
+    Resampler::Quality pendingQuality = Resampler::Quality::standard;
+    Resampler::Quality quality = Resampler::Quality::standard;
+
+    // Steal-selection state
+    static constexpr int stealFadeLength = 64;
+    bool releasing = false;
+    float lastEnvelopeLevel = 0.0f;
+    juce::uint32 noteStartMs = 0;
+    int stealFadeSamples = 0;
+    int shedFadeSamples = 0;  // governor fade-out; counts down to the cull
+
+    // Per-block scratch (sized in prepareToPlay) so the render kernel runs
+    // channel-major: positions, fractions and the gain ramp are resolved up
+    // front, then each channel is one tight contiguous loop
+    std::vector<float> gainScratch;
+    std::vector<float> partnerGainScratch;
+    std::vector<float> fracScratch;
+    std::vector<int> posScratch;
+    std::vector<int> partnerPosScratch;
 };
@@ -0,0 +1,552 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "DiskStreaming.h"
+#include "DiskStreamer.h"
+#include "InstrumentLoader.h"
+#include "PreloadVoice.h"
+#include "Resampler.h"
+#include "StreamingMetrics.h"
+#include "StreamingVoice.h"
+
+/**
+ * SamplerBench - headless benchmark and stress-test driver for the render
+ * and streaming engines.
+ *
+ * Links the engine sources directly (no plugin wrapper, no editor) and runs
+ * scripted scenarios:
+ *
+ *   render [voices]        sustained N-voice render throughput
+ *   storm  [seconds]       note-storm MIDI replay, per-block percentiles
+ *   load   <instrument>    cold/warm instrument load timing
+ *   stream [latencyMs]     paced streaming run with synthetic disk latency,
+ *                          validating underrun behaviour via StreamingMetrics
+ *
+ * With no arguments the self-contained scenarios (render, storm, stream) all
+ * run with their defaults. Each scenario emits one line of JSON on stdout so
+ * results can be regression-tracked per commit; human-readable notes go to
+ * stderr and never pollute the data stream.
+ */
+
+namespace
+{
+
+constexpr double benchSampleRate = 44100.0;
+constexpr int benchBlockSize = 512;
+
+void logNote(const juce::String& text)
+{
+    std::fprintf(stderr, "%s\n", text.toRawUTF8());
+}
+
+void emitResult(const juce::String& scenario, std::initializer_list<std::pair<juce::String, juce::var>> fields)
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("bench", scenario);
+
+    for (const auto& field : fields)
+        object->setProperty(field.first, field.second);
+
+    std::printf("%s\n", juce::JSON::toString(juce::var(object), true).toRawUTF8());
+    std::fflush(stdout);
+}
+
+/** Builds a fully-in-RAM synthetic sample: a decaying sawtooth-ish tone that
+    exercises the interpolators with broadband content. The preload covers
+    the whole file, so PreloadVoice can play it and needsStreaming is false. */
+PreloadedSample makeRamSample(double seconds, int rootNote)
+{
+    PreloadedSample sample;
+    int frames = static_cast<int>(seconds * benchSampleRate);
+
+    sample.preloadBuffer.setSize(2, frames);
+    double phase = 0.0;
+    double increment = juce::MidiMessage::getMidiNoteInHertz(rootNote) / benchSampleRate;
+
+    for (int i = 0; i < frames; ++i)
+    {
+        float envelope = 1.0f - static_cast<float>(i) / static_cast<float>(frames);
+        float value = static_cast<float>(2.0 * phase - 1.0) * 0.5f * envelope;
+        sample.preloadBuffer.setSample(0, i, value);
+        sample.preloadBuffer.setSample(1, i, -value);
+
+        phase += increment;
+        if (phase >= 1.0)
+            phase -= 1.0;
+    }
+
+    sample.filePath = "<synthetic>";
+    sample.name = "bench";
+    sample.totalSampleFrames = frames;
+    sample.sampleRate = benchSampleRate;
+    sample.numChannels = 2;
+    sample.rootNote = rootNote;
+    sample.preloadSizeFrames = frames;
+    return sample;
+}
+
+/** Writes the synthetic tone out as a real WAV so the streaming path reads
+    it through an actual AudioFormatReader. Returns an invalid File on
+    failure. The extension is the caller's choice so the latency-injecting
+    format can claim the file instead of the stock WAV reader. */
+juce::File writeStreamingFile(double seconds, int rootNote, const juce::String& extension)
+{
+    auto file = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                    .getChildFile("samplerbench_" + juce::String(rootNote) + extension);
+
+    auto source = makeRamSample(seconds, rootNote);
+
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+    if (stream == nullptr)
+        return {};
+
+    stream->setPosition(0);
+    stream->truncate();
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        wavFormat.createWriterFor(stream.get(), benchSampleRate, 2, 16, {}, 0));
+    if (writer == nullptr)
+        return {};
+
+    stream.release();  // writer owns it now
+    writer->writeFromAudioSampleBuffer(source.preloadBuffer, 0, source.preloadBuffer.getNumSamples());
+    writer.reset();
+
+    return file;
+}
+
+// ==================== Synthetic disk latency injection ====================
+
+/** Wraps a real reader and sleeps a fixed time before every read, modelling
+    a slow device or network share. Registered for the .slowwav extension so
+    DiskStreamer's format lookup hands the delay out transparently. */
+class SlowAudioFormatReader : public juce::AudioFormatReader
+{
+public:
+    SlowAudioFormatReader(std::unique_ptr<juce::AudioFormatReader> innerReader, int latencyToInjectMs)
+        : juce::AudioFormatReader(nullptr, "SlowWAV"),
+          inner(std::move(innerReader)),
+          latencyMs(latencyToInjectMs)
+    {
+        sampleRate = inner->sampleRate;
+        bitsPerSample = inner->bitsPerSample;
+        lengthInSamples = inner->lengthInSamples;
+        numChannels = inner->numChannels;
+        usesFloatingPointData = inner->usesFloatingPointData;
+        metadataValues = inner->metadataValues;
+    }
+
+    bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                     juce::int64 startSampleInFile, int numSamples) override
+    {
+        if (latencyMs > 0)
+            juce::Thread::sleep(latencyMs);
+
+        // Delegate through the inner reader's public API, offsetting the
+        // destination pointers by hand
+        std::vector<int*> offsetDest(static_cast<size_t>(numDestChannels));
+        for (int ch = 0; ch < numDestChannels; ++ch)
+            offsetDest[static_cast<size_t>(ch)] =
+                destChannels[ch] != nullptr ? destChannels[ch] + startOffsetInDestBuffer : nullptr;
+
+        return inner->read(offsetDest.data(), numDestChannels, startSampleInFile, numSamples, true);
+    }
+
+private:
+    std::unique_ptr<juce::AudioFormatReader> inner;
+    int latencyMs;
+};
+
+class SlowWavAudioFormat : public juce::AudioFormat
+{
+public:
+    explicit SlowWavAudioFormat(int latencyToInjectMs)
+        : juce::AudioFormat("SlowWAV", ".slowwav"), latencyMs(latencyToInjectMs) {}
+
+    juce::Array<int> getPossibleSampleRates() override { return {}; }
+    juce::Array<int> getPossibleBitDepths() override { return {}; }
+    bool canDoStereo() override { return true; }
+    bool canDoMono() override { return true; }
+
+    juce::AudioFormatReader* createReaderFor(juce::InputStream* sourceStream,
+                                             bool deleteStreamIfOpeningFails) override
+    {
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatReader> inner(
+            wavFormat.createReaderFor(sourceStream, deleteStreamIfOpeningFails));
+
+        if (inner == nullptr)
+            return nullptr;
+
+        return new SlowAudioFormatReader(std::move(inner), latencyMs);
+    }
+
+    juce::AudioFormatWriter* createWriterFor(juce::OutputStream*, double, unsigned int, int,
+                                             const juce::StringPairArray&, int) override
+    {
+        return nullptr;  // read-only format
+    }
+
+private:
+    int latencyMs;
+};
+
+// ==================== Shared measurement helpers ====================
+
+struct Percentiles
+{
+    double p50 = 0.0, p90 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+Percentiles computePercentiles(std::vector<double>& samples)
+{
+    Percentiles result;
+    if (samples.empty())
+        return result;
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double fraction)
+    {
+        auto index = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1));
+        return samples[index];
+    };
+
+    result.p50 = at(0.50);
+    result.p90 = at(0.90);
+    result.p99 = at(0.99);
+    result.max = samples.back();
+    return result;
+}
+
+double ticksToMs(juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+}
+
+// ==================== Scenario: sustained render throughput ====================
+
+void runRenderBench(int numVoices)
+{
+    logNote("render: " + juce::String(numVoices) + " sustained voices...");
+
+    auto sample = makeRamSample(30.0, 48);
+
+    std::vector<PreloadVoice> voices(static_cast<size_t>(numVoices));
+    juce::ADSR::Parameters adsrParams{0.001f, 0.1f, 0.8f, 0.5f};
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        voices[static_cast<size_t>(i)].prepareToPlay(benchSampleRate, benchBlockSize);
+        voices[static_cast<size_t>(i)].setADSRParameters(adsrParams);
+        // Spread notes over two octaves so every voice runs a different pitch
+        // ratio but none consumes the 30s file before the run ends
+        voices[static_cast<size_t>(i)].startVoice(&sample, 36 + (i % 25), 0.8f, benchSampleRate);
+    }
+
+    constexpr double renderSeconds = 10.0;
+    const int numBlocks = static_cast<int>(renderSeconds * benchSampleRate / benchBlockSize);
+    juce::AudioBuffer<float> output(2, benchBlockSize);
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        output.clear();
+        for (auto& voice : voices)
+            voice.renderNextBlock(output, 0, benchBlockSize);
+    }
+
+    double wallSeconds = juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - startTicks);
+    double audioSeconds = numBlocks * benchBlockSize / benchSampleRate;
+    double xRealtime = audioSeconds / wallSeconds;
+    int numCores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    emitResult("render", {
+        { "voices", numVoices },
+        { "blockSize", benchBlockSize },
+        { "audioSeconds", audioSeconds },
+        { "wallSeconds", wallSeconds },
+        { "xRealtime", xRealtime },
+        { "voicesPerCore", numVoices * xRealtime / numCores },
+        { "cores", numCores },
+    });
+}
+
+// ==================== Scenario: note-storm percentiles ====================
+
+void runStormBench(double seconds)
+{
+    logNote("storm: " + juce::String(seconds, 1) + "s note storm...");
+
+    auto sample = makeRamSample(4.0, 48);
+
+    constexpr int poolSize = StreamingConstants::maxPreloadVoices;
+    std::vector<PreloadVoice> voices(static_cast<size_t>(poolSize));
+    juce::ADSR::Parameters adsrParams{0.001f, 0.1f, 0.8f, 0.3f};
+
+    for (auto& voice : voices)
+    {
+        voice.prepareToPlay(benchSampleRate, benchBlockSize);
+        voice.setADSRParameters(adsrParams);
+    }
+
+    // Seeded so every run replays the same storm
+    juce::Random random(0x5a3b17);
+    const int numBlocks = static_cast<int>(seconds * benchSampleRate / benchBlockSize);
+    juce::AudioBuffer<float> output(2, benchBlockSize);
+
+    std::vector<double> blockMs;
+    blockMs.reserve(static_cast<size_t>(numBlocks));
+    int nextSteal = 0;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        // ~8 note-ons and ~4 note-offs per block, far denser than any
+        // playable material
+        for (int i = 0; i < 8; ++i)
+        {
+            int note = 24 + random.nextInt(72);
+            bool started = false;
+
+            for (auto& voice : voices)
+            {
+                if (!voice.isActive())
+                {
+                    voice.startVoice(&sample, note, 0.5f + random.nextFloat() * 0.5f, benchSampleRate);
+                    started = true;
+                    break;
+                }
+            }
+
+            if (!started)
+            {
+                auto& victim = voices[static_cast<size_t>(nextSteal++ % poolSize)];
+                victim.stopVoice(false);
+                victim.startVoice(&sample, note, 0.5f + random.nextFloat() * 0.5f, benchSampleRate);
+                victim.applyStealFadeIn();
+            }
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            auto& voice = voices[static_cast<size_t>(random.nextInt(poolSize))];
+            if (voice.isActive())
+                voice.stopVoice(true);
+        }
+
+        auto blockStart = juce::Time::getHighResolutionTicks();
+        output.clear();
+        for (auto& voice : voices)
+            voice.renderNextBlock(output, 0, benchBlockSize);
+        blockMs.push_back(ticksToMs(juce::Time::getHighResolutionTicks() - blockStart));
+    }
+
+    auto percentiles = computePercentiles(blockMs);
+    double budgetMs = benchBlockSize / benchSampleRate * 1000.0;
+
+    emitResult("storm", {
+        { "seconds", seconds },
+        { "blockSize", benchBlockSize },
+        { "blocks", numBlocks },
+        { "budgetMs", budgetMs },
+        { "p50Ms", percentiles.p50 },
+        { "p90Ms", percentiles.p90 },
+        { "p99Ms", percentiles.p99 },
+        { "maxMs", percentiles.max },
+    });
+}
+
+// ==================== Scenario: instrument load timing ====================
+
+void runLoadBench(const juce::File& definitionFile)
+{
+    if (!definitionFile.existsAsFile())
+    {
+        logNote("load: file not found: " + definitionFile.getFullPathName());
+        return;
+    }
+
+    logNote("load: " + definitionFile.getFullPathName());
+
+    InstrumentLoader loader;
+
+    // First load pays whatever the OS cache state is (cold when the bench
+    // runs freshly); second load measures the warm path
+    auto firstStart = juce::Time::getHighResolutionTicks();
+    auto firstLoad = loader.loadInstrument(definitionFile);
+    double firstMs = ticksToMs(juce::Time::getHighResolutionTicks() - firstStart);
+
+    auto secondStart = juce::Time::getHighResolutionTicks();
+    auto secondLoad = loader.loadInstrument(definitionFile);
+    double secondMs = ticksToMs(juce::Time::getHighResolutionTicks() - secondStart);
+
+    emitResult("load", {
+        { "file", definitionFile.getFullPathName() },
+        { "zones", static_cast<int>(firstLoad.zones.size()) },
+        { "valid", firstLoad.isValid() && secondLoad.isValid() },
+        { "firstLoadMs", firstMs },
+        { "warmLoadMs", secondMs },
+    });
+}
+
+// ==================== Scenario: paced streaming with injected latency ====================
+
+void runStreamBench(int latencyMs)
+{
+    logNote("stream: paced render, injected disk latency " + juce::String(latencyMs) + " ms...");
+
+    constexpr int numVoices = 16;
+    constexpr double fileSeconds = 20.0;
+    constexpr double runSeconds = 8.0;
+
+    // One file per voice, claimed by the latency-injecting format
+    juce::AudioFormatManager formatManager;
+    formatManager.registerFormat(new SlowWavAudioFormat(latencyMs), false);
+    formatManager.registerBasicFormats();
+
+    std::vector<PreloadedSample> samples;
+    for (int i = 0; i < numVoices; ++i)
+    {
+        auto file = writeStreamingFile(fileSeconds, 36 + i, ".slowwav");
+        if (file == juce::File())
+        {
+            logNote("stream: could not write temp files, skipping");
+            return;
+        }
+
+        auto sample = makeRamSample(fileSeconds, 36 + i);
+        sample.filePath = file.getFullPathName();
+        sample.name = file.getFileNameWithoutExtension();
+
+        // Keep only a small preload so the voices stream almost immediately
+        sample.preloadSizeFrames = 8192;
+        juce::AudioBuffer<float> preload(2, sample.preloadSizeFrames);
+        for (int ch = 0; ch < 2; ++ch)
+            preload.copyFrom(ch, 0, sample.preloadBuffer, ch, 0, sample.preloadSizeFrames);
+        sample.preloadBuffer = std::move(preload);
+
+        samples.push_back(std::move(sample));
+    }
+
+    StreamingMetrics metrics;
+    std::vector<StreamingVoice> voices(numVoices);
+
+    DiskStreamer streamer;
+    streamer.setAudioFormatManager(&formatManager);
+    streamer.setMetrics(&metrics);
+
+    juce::ADSR::Parameters adsrParams{0.001f, 0.1f, 0.8f, 0.5f};
+    for (int i = 0; i < numVoices; ++i)
+    {
+        voices[static_cast<size_t>(i)].prepareToPlay(benchSampleRate, benchBlockSize);
+        voices[static_cast<size_t>(i)].setADSRParameters(adsrParams);
+        voices[static_cast<size_t>(i)].setMetrics(&metrics);
+        streamer.registerVoice(i, &voices[static_cast<size_t>(i)]);
+    }
+
+    streamer.startThread();
+
+    for (int i = 0; i < numVoices; ++i)
+        voices[static_cast<size_t>(i)].startVoice(&samples[static_cast<size_t>(i)],
+                                                  36 + i, 0.8f, benchSampleRate);
+
+    // Render paced at the real callback cadence, so a starving ring shows up
+    // as an underrun exactly as it would live
+    const int numBlocks = static_cast<int>(runSeconds * benchSampleRate / benchBlockSize);
+    const double blockSeconds = benchBlockSize / benchSampleRate;
+    juce::AudioBuffer<float> output(2, benchBlockSize);
+    std::vector<double> blockMs;
+    blockMs.reserve(static_cast<size_t>(numBlocks));
+
+    auto deadline = juce::Time::getHighResolutionTicks();
+    auto ticksPerBlock = static_cast<juce::int64>(blockSeconds / juce::Time::highResolutionTicksToSeconds(1));
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        auto blockStart = juce::Time::getHighResolutionTicks();
+        output.clear();
+        for (auto& voice : voices)
+            voice.renderNextBlock(output, 0, benchBlockSize);
+        blockMs.push_back(ticksToMs(juce::Time::getHighResolutionTicks() - blockStart));
+
+        deadline += ticksPerBlock;
+        auto remaining = deadline - juce::Time::getHighResolutionTicks();
+        if (remaining > 0)
+            juce::Thread::sleep(static_cast<int>(ticksToMs(remaining)));
+    }
+
+    streamer.stopThread();
+
+    StreamingMetrics::Snapshot snapshot;
+    metrics.readCounters(snapshot);
+    auto percentiles = computePercentiles(blockMs);
+
+    int voicesStillActive = 0;
+    for (auto& voice : voices)
+        if (voice.isActive())
+            ++voicesStillActive;
+
+    emitResult("stream", {
+        { "voices", numVoices },
+        { "injectedLatencyMs", latencyMs },
+        { "seconds", runSeconds },
+        { "underruns", static_cast<int>(snapshot.underruns) },
+        { "diskReads", static_cast<int>(snapshot.diskReads) },
+        { "worstDiskReadUs", static_cast<int>(snapshot.worstDiskReadUs) },
+        { "activeVoicesAtEnd", voicesStillActive },
+        { "renderP99Ms", percentiles.p99 },
+        { "renderMaxMs", percentiles.max },
+    });
+
+    for (const auto& sample : samples)
+        juce::File(sample.filePath).deleteFile();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::String scenario = argc > 1 ? juce::String(argv[1]) : juce::String("all");
+
+    // Build the sinc table up front, exactly as prepareToPlay does, so no
+    // scenario measures its one-time construction
+    Resampler::getSincTable();
+
+    if (scenario == "render" || scenario == "all")
+        runRenderBench(argc > 2 ? juce::String(argv[2]).getIntValue() : 64);
+
+    if (scenario == "storm" || scenario == "all")
+        runStormBench(argc > 2 ? juce::String(argv[2]).getDoubleValue() : 10.0);
+
+    if (scenario == "load")
+    {
+        if (argc < 3)
+        {
+            logNote("usage: SamplerBench load <instrument.sss>");
+            return 1;
+        }
+        runLoadBench(juce::File(juce::String(argv[2])));
+    }
+
+    if (scenario == "stream" || scenario == "all")
+    {
+        if (scenario == "stream" && argc > 2)
+        {
+            runStreamBench(juce::String(argv[2]).getIntValue());
+        }
+        else
+        {
+            // Healthy baseline, then a latency high enough to provoke
+            // underruns, so both sides of the behaviour stay covered
+            runStreamBench(0);
+            runStreamBench(40);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <array>
+#include "DiskStreaming.h"
+
+/**
+ * Lock-free health counters for the streaming engine.
+ *
+ * Writers are the audio thread (underruns, callback duration) and the disk
+ * thread (read latencies); everything is a relaxed atomic, so recording a
+ * sample is a handful of instructions and never blocks. The editor polls a
+ * consistent-enough Snapshot from its timer, and a full report can be
+ * exported as text for offline tuning of preload sizes against a venue's
+ * storage.
+ */
+class StreamingMetrics
+{
+public:
+    // Disk read latency buckets: <1ms, <2, <4, <8, <16, <32, <64, >=64
+    static constexpr int numLatencyBuckets = 8;
+
+    struct Snapshot
+    {
+        juce::uint32 underruns = 0;
+        juce::uint32 diskReads = 0;
+        juce::uint32 loadSheds = 0;
+        juce::uint32 worstCallbackUs = 0;
+        juce::uint32 worstDiskReadUs = 0;
+        std::array<juce::uint32, numLatencyBuckets> latencyHistogram{};
+
+        int activeVoices = 0;
+        std::array<float, StreamingConstants::maxStreamingVoices> ringFillPercent{};
+    };
+
+    // ---- Recording (realtime-safe, any thread) ----
+
+    void noteUnderrun()
+    {
+        underrunCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // One shed action by the render budget governor (a quality step down or
+    // a faded voice); a rising count means the machine is too slow for the
+    // buffer size it is being asked to run
+    void noteLoadShed()
+    {
+        loadShedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void recordDiskRead(juce::uint32 microseconds)
+    {
+        diskReadCount.fetch_add(1, std::memory_order_relaxed);
+
+        int bucket = 0;
+        juce::uint32 upperMs = 1;
+        while (bucket < numLatencyBuckets - 1 && microseconds >= upperMs * 1000)
+        {
+            upperMs *= 2;
+            ++bucket;
+        }
+        latencyBuckets[static_cast<size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+
+        updateMax(worstDiskReadUs, microseconds);
+    }
+
+    void recordCallback(juce::uint32 microseconds)
+    {
+        updateMax(worstCallbackUs, microseconds);
+    }
+
+    // ---- Reading (editor / message thread) ----
+
+    // Counters only; the caller fills in the per-voice ring levels, which
+    // live on the voices themselves
+    void readCounters(Snapshot& out) const
+    {
+        out.underruns = underrunCount.load(std::memory_order_relaxed);
+        out.diskReads = diskReadCount.load(std::memory_order_relaxed);
+        out.loadSheds = loadShedCount.load(std::memory_order_relaxed);
+        out.worstCallbackUs = worstCallbackUs.load(std::memory_order_relaxed);
+        out.worstDiskReadUs = worstDiskReadUs.load(std::memory_order_relaxed);
+
+        for (int i = 0; i < numLatencyBuckets; ++i)
+            out.latencyHistogram[static_cast<size_t>(i)] =
+                latencyBuckets[static_cast<size_t>(i)].load(std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        underrunCount.store(0, std::memory_order_relaxed);
+        diskReadCount.store(0, std::memory_order_relaxed);
+        loadShedCount.store(0, std::memory_order_relaxed);
+        worstCallbackUs.store(0, std::memory_order_relaxed);
+        worstDiskReadUs.store(0, std::memory_order_relaxed);
+        for (auto& bucket : latencyBuckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+
+    static juce::String formatReport(const Snapshot& s)
+    {
+        juce::String report;
+        report << "=== Streaming health report ===\n";
+        report << "Underruns: " << juce::String(s.underruns) << "\n";
+        report << "Disk reads: " << juce::String(s.diskReads) << "\n";
+        report << "Governor sheds: " << juce::String(s.loadSheds) << "\n";
+        report << "Worst callback: " << juce::String(s.worstCallbackUs) << " us\n";
+        report << "Worst disk read: " << juce::String(s.worstDiskReadUs) << " us\n";
+
+        report << "Disk read latency histogram:\n";
+        juce::uint32 upperMs = 1;
+        for (int i = 0; i < numLatencyBuckets; ++i)
+        {
+            if (i < numLatencyBuckets - 1)
+                report << "  < " << juce::String(upperMs) << " ms: ";
+            else
+                report << "  >= " << juce::String(upperMs / 2) << " ms: ";
+
+            report << juce::String(s.latencyHistogram[static_cast<size_t>(i)]) << "\n";
+            upperMs *= 2;
+        }
+
+        report << "Active voices: " << juce::String(s.activeVoices) << "\n";
+        for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
+        {
+            float fill = s.ringFillPercent[static_cast<size_t>(i)];
+            if (fill >= 0.0f)
+                report << "  voice " << juce::String(i) << ": ring "
+                       << juce::String(fill, 1) << "%\n";
+        }
+
+        return report;
+    }
+
+private:
+    static void updateMax(std::atomic<juce::uint32>& target, juce::uint32 value)
+    {
+        juce::uint32 current = target.load(std::memory_order_relaxed);
+        while (value > current
+               && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::atomic<juce::uint32> underrunCount{0};
+    std::atomic<juce::uint32> diskReadCount{0};
+    std::atomic<juce::uint32> loadShedCount{0};
+    std::atomic<juce::uint32> worstCallbackUs{0};
+    std::atomic<juce::uint32> worstDiskReadUs{0};
+    std::array<std::atomic<juce::uint32>, numLatencyBuckets> latencyBuckets{};
+};
@@ -1,13 +1,6 @@
 #include "StreamingVoice.h"
-
-// Debug logging to file
-static void voiceDebugLog(const juce::String& msg)
-{
-    auto logFile = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
-                       .getChildFile("sampler_streaming_debug.txt");
-    auto timestamp = juce::Time::getCurrentTime().toString(true, true, true, true);
-    logFile.appendText("[" + timestamp + "] " + msg + "\n");
-}
+#include "Trace.h"
+#include <cmath>
 
 StreamingVoice::StreamingVoice()
 {
@@ -18,9 +11,15 @@ StreamingVoice::StreamingVoice()
 
 StreamingVoice::~StreamingVoice() = default;
 
-void StreamingVoice::prepareToPlay(double sampleRate, int /*samplesPerBlock*/)
+void StreamingVoice::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     adsr.setSampleRate(sampleRate);
+
+    // Scratch arrays for the block-based render kernel
+    auto scratchSize = static_cast<size_t>(std::max(samplesPerBlock, 64));
+    gainScratch.resize(scratchSize);
+    fracScratch.resize(scratchSize);
+    posScratch.resize(scratchSize);
 }
 
 void StreamingVoice::setADSRParameters(const juce::ADSR::Parameters& params)
@@ -55,21 +54,41 @@ void StreamingVoice::startVoice(const PreloadedSample* sample, int midiNote, flo
     endOfFile.store(false, std::memory_order_release);
     readError.store(false, std::memory_order_release);
     isUnderrunning = false;
-    underrunFadePosition = 0;
     sustainedByPedal = false;
-
-    // Copy preload buffer into beginning of ring buffer
+    releasing = false;
+    shedFadeSamples = 0;
+    lastEnvelopeLevel = 0.0f;
+    noteStartMs = juce::Time::getMillisecondCounter();
+    quality = pendingQuality;
+
+    // Copy preload buffer into beginning of ring buffer. If the preload is
+    // larger than the ring, only the first ringBufferFrames are seeded - the
+    // invariant that source frame n lives at slot (n % ringBufferFrames)
+    // must hold from frame 0, so the overhang is streamed from disk instead.
     const auto& preload = sample->preloadBuffer;
     int preloadFrames = preload.getNumSamples();
     int framesToCopy = std::min(preloadFrames, StreamingConstants::ringBufferFrames);
 
+    // For looping samples the disk thread bakes the loop crossfade into the
+    // stream, so the seed must stop before the crossfade window - frames at
+    // and past it come from disk with the blend applied
+    if (sample->hasLoop())
+    {
+        auto loopLength = sample->loopEndFrame - sample->loopStartFrame;
+        auto crossfade = std::min<int64_t>({ StreamingConstants::loopCrossfadeFrames,
+                                             sample->loopStartFrame, loopLength });
+        framesToCopy = static_cast<int>(juce::jlimit<int64_t>(
+            0, framesToCopy, sample->loopEndFrame - crossfade));
+    }
+
     ringBuffer.clear();
     for (int ch = 0; ch < std::min(preload.getNumChannels(), ringBuffer.getNumChannels()); ++ch)
     {
         ringBuffer.copyFrom(ch, 0, preload, ch, 0, framesToCopy);
     }
 
-    // Set initial write position after preloaded data
+    // Both monotonic counters start at the seeded frame count, keeping the
+    // write head and the disk file position in lockstep from the first fill
     writePosition.store(framesToCopy, std::memory_order_release);
     fileReadPosition.store(framesToCopy, std::memory_order_release);
 
@@ -79,18 +98,15 @@ void StreamingVoice::startVoice(const PreloadedSample* sample, int midiNote, flo
     // Signal that we need more data (disk thread will start filling)
     if (sample->needsStreaming())
     {
-        needsData.store(true, std::memory_order_release);
+        signalNeedsData();
     }
 
     // Mark voice as active last (ensures all state is visible to disk thread)
     active.store(true, std::memory_order_release);
 
-    voiceDebugLog("StreamingVoice::startVoice - note=" + juce::String(midiNote)
-                 + " sample=" + sample->name
-                 + " totalFrames=" + juce::String(sample->totalSampleFrames)
-                 + " preloadFrames=" + juce::String(sample->preloadSizeFrames)
-                 + " needsStreaming=" + juce::String(sample->needsStreaming() ? "YES" : "no")
-                 + " pitchRatio=" + juce::String(pitchRatio, 4));
+    Trace::post(Trace::Event::voiceStart, voiceIndex, midiNote,
+                sample->totalSampleFrames, sample->preloadSizeFrames,
+                static_cast<juce::int64>(pitchRatio * 1000.0));
 }
 
 void StreamingVoice::stopVoice(bool allowTailOff)
@@ -98,6 +114,7 @@ void StreamingVoice::stopVoice(bool allowTailOff)
     if (allowTailOff)
     {
         adsr.noteOff();
+        releasing = true;
     }
     else
     {
@@ -112,7 +129,11 @@ void StreamingVoice::reset()
     adsr.reset();
     playingNote = -1;
     sustainedByPedal = false;
+    releasing = false;
+    shedFadeSamples = 0;
+    lastEnvelopeLevel = 0.0f;
     currentSample = nullptr;
+    retainedSet.reset();
 }
 
 void StreamingVoice::noteReleasedWithPedal(bool pedalDown)
@@ -124,6 +145,7 @@ void StreamingVoice::noteReleasedWithPedal(bool pedalDown)
     else
     {
         adsr.noteOff();
+        releasing = true;
     }
 }
 
@@ -133,6 +155,7 @@ void StreamingVoice::setSustainPedal(bool isDown)
     {
         sustainedByPedal = false;
         adsr.noteOff();
+        releasing = true;
     }
 }
 
@@ -140,7 +163,15 @@ int StreamingVoice::samplesAvailable() const
 {
     int64_t read = readPosition.load(std::memory_order_acquire);
     int64_t write = writePosition.load(std::memory_order_acquire);
-    return static_cast<int>(write - read);
+
+    // The distance is computed in int64 and clamped before narrowing: a
+    // transiently inconsistent pair of loads (or a reader fractionally ahead
+    // after a pitched-up block) must never produce a negative or oversized
+    // count that the disk thread would misread as free space.
+    int64_t available = write - read;
+    available = std::max<int64_t>(0, std::min<int64_t>(available, StreamingConstants::ringBufferFrames));
+
+    return static_cast<int>(available);
 }
 
 int StreamingVoice::spaceAvailable() const
@@ -169,7 +200,20 @@ void StreamingVoice::checkAndRequestData()
     int available = samplesAvailable();
     if (available < StreamingConstants::lowWatermarkFrames)
     {
-        needsData.store(true, std::memory_order_release);
+        signalNeedsData();
+    }
+}
+
+void StreamingVoice::signalNeedsData()
+{
+    // Only the false->true transition queues a request, so a voice that is
+    // already pending doesn't flood the queue. If a request races with the
+    // disk thread clearing the flag, the next render block retries - at worst
+    // one block of extra latency, against the old worst case of a full poll.
+    if (!needsData.exchange(true, std::memory_order_acq_rel))
+    {
+        if (requestQueue != nullptr)
+            requestQueue->push(voiceIndex);
     }
 }
 
@@ -188,131 +232,276 @@ void StreamingVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int
     if (!active.load(std::memory_order_acquire) || currentSample == nullptr)
         return;
 
+    // Grow scratch if the host delivers a bigger block than it prepared us for
+    if (static_cast<size_t>(numSamples) > posScratch.size())
+    {
+        jassertfalse;  // host exceeded samplesPerBlock from prepareToPlay
+        gainScratch.resize(static_cast<size_t>(numSamples));
+        fracScratch.resize(static_cast<size_t>(numSamples));
+        posScratch.resize(static_cast<size_t>(numSamples));
+    }
+
     const int numOutputChannels = outputBuffer.getNumChannels();
     const int numSourceChannels = currentSample->numChannels;
     const int64_t totalSourceFrames = currentSample->totalSampleFrames;
     const bool isStreaming = currentSample->needsStreaming();
 
-    int64_t currentReadPos = readPosition.load(std::memory_order_acquire);
-    int64_t currentWritePos = writePosition.load(std::memory_order_acquire);
+    // A looping sample never reaches end-of-source: the disk thread streams
+    // the loop body (with the junction crossfade baked in) indefinitely, and
+    // the monotonic stream position simply keeps climbing
+    const bool looping = currentSample->hasLoop();
+    constexpr int ringFrames = StreamingConstants::ringBufferFrames;
+
+    // ---- Resolve all block boundaries up front so the per-channel loops are branch-free ----
 
-    for (int sample = 0; sample < numSamples; ++sample)
+    if (!looping && sourceSamplePosition >= static_cast<double>(totalSourceFrames))
     {
-        // Check if we've reached end of sample
-        if (sourceSamplePosition >= totalSourceFrames)
+        reset();
+        return;
+    }
+
+    // Frames until the source runs out
+    int framesToRender = numSamples;
+    if (!looping)
+    {
+        double remaining = static_cast<double>(totalSourceFrames) - sourceSamplePosition;
+        int bySource = static_cast<int>(std::ceil(remaining / pitchRatio));
+        framesToRender = std::min(framesToRender, std::max(bySource, 0));
+    }
+
+    // Frames covered by streamed data: the kernel's look-ahead taps
+    // (pos0 + framesAhead) must stay behind the write head
+    bool starved = false;
+    if (isStreaming && !hasReachedEndOfFile())
+    {
+        int64_t writePos = writePosition.load(std::memory_order_acquire);
+        double lastReadable = static_cast<double>(writePos - 1 - Resampler::framesAhead(quality));
+        double span = lastReadable - sourceSamplePosition;
+        int byRing = span < 0.0 ? 0 : static_cast<int>(span / pitchRatio) + 1;
+
+        if (byRing < framesToRender)
         {
-            reset();
-            return;
+            framesToRender = byRing;
+            starved = true;
         }
+    }
+
+    // Underrun: the disk thread fell behind while the file still has data.
+    // Render whatever the ring does hold with a fade to silence folded into
+    // the gain ramp below, then stop the voice - ending cleanly beats holding
+    // the slot open hoping the disk catches up mid-note.
+    if (starved && !isUnderrunning)
+    {
+        isUnderrunning = true;
 
-        // Get envelope value
-        float envelopeValue = adsr.getNextSample();
+        if (metrics != nullptr)
+            metrics->noteUnderrun();
+    }
+
+    if (framesToRender <= 0)
+    {
+        reset();
+        return;
+    }
+
+    // ---- Envelope and gain as a per-block ramp ----
+
+    bool envelopeEnded = false;
+    int envFrames = framesToRender;
+    for (int i = 0; i < framesToRender; ++i)
+    {
+        float env = adsr.getNextSample();
+        lastEnvelopeLevel = env;
+        gainScratch[static_cast<size_t>(i)] = env * velocity;
         if (!adsr.isActive())
         {
-            reset();
-            return;
+            envFrames = i + 1;
+            envelopeEnded = true;
+            break;
         }
+    }
+    framesToRender = envFrames;
 
-        // Handle underrun
-        if (isStreaming)
+    // Short ramp up after a steal to mask the previous note's hard cut
+    if (stealFadeSamples > 0)
+    {
+        for (int i = 0; i < framesToRender && stealFadeSamples > 0; ++i)
         {
-            int available = static_cast<int>(currentWritePos - currentReadPos);
-            if (available <= 2 && !hasReachedEndOfFile())
-            {
-                // Buffer underrun - fade out to avoid click
-                if (!isUnderrunning)
-                {
-                    isUnderrunning = true;
-                    underrunFadePosition = 0;
-                }
-            }
+            gainScratch[static_cast<size_t>(i)] *= static_cast<float>(stealFadeLength - stealFadeSamples)
+                                                   / static_cast<float>(stealFadeLength);
+            stealFadeSamples--;
         }
+    }
 
-        // Calculate underrun fade
-        float underrunFade = 1.0f;
-        if (isUnderrunning)
+    // Governor shed: ramp down to silence, then free the voice
+    bool shedFadeEnded = false;
+    if (shedFadeSamples > 0)
+    {
+        for (int i = 0; i < framesToRender; ++i)
         {
-            underrunFade = 1.0f - (static_cast<float>(underrunFadePosition) / StreamingConstants::underrunFadeOutSamples);
-            if (underrunFade <= 0.0f)
+            gainScratch[static_cast<size_t>(i)] *= static_cast<float>(shedFadeSamples)
+                                                   / static_cast<float>(stealFadeLength);
+            if (--shedFadeSamples == 0)
             {
-                // Fully faded out due to underrun - stop voice
-                reset();
-                return;
+                framesToRender = i + 1;
+                shedFadeEnded = true;
+                break;
             }
-            underrunFadePosition++;
         }
+    }
 
-        // Calculate interpolated sample position
-        int64_t pos0 = static_cast<int64_t>(sourceSamplePosition);
-        int64_t pos1 = pos0 + 1;
-        float frac = static_cast<float>(sourceSamplePosition - static_cast<double>(pos0));
+    // Underrun fade: ramp the final renderable frames down to zero so the
+    // voice reaches silence on real audio instead of cutting mid-waveform
+    if (isUnderrunning)
+    {
+        int fadeFrames = std::min(framesToRender, StreamingConstants::underrunFadeOutSamples);
+        int fadeStart = framesToRender - fadeFrames;
+        for (int i = 0; i < fadeFrames; ++i)
+            gainScratch[static_cast<size_t>(fadeStart + i)] *= static_cast<float>(fadeFrames - 1 - i)
+                                                              / static_cast<float>(fadeFrames);
+    }
 
-        // Clamp pos1 to valid range
-        if (pos1 >= totalSourceFrames)
-            pos1 = pos0;
+    // ---- Source positions and interpolation fractions, computed once ----
 
-        // Read from appropriate source (preload buffer or ring buffer)
-        for (int ch = 0; ch < numOutputChannels; ++ch)
+    double srcPos = sourceSamplePosition;
+    if (isStreaming)
+    {
+        for (int i = 0; i < framesToRender; ++i)
         {
-            float sample0, sample1;
-
-            int sourceChannel = std::min(ch, numSourceChannels - 1);
-
-            if (!isStreaming)
-            {
-                // Small sample - read directly from preload buffer
-                const auto& preload = currentSample->preloadBuffer;
-                sample0 = preload.getSample(sourceChannel, static_cast<int>(pos0));
-                sample1 = preload.getSample(sourceChannel, static_cast<int>(pos1));
-            }
-            else
-            {
-                // Streaming - read from ring buffer with wraparound
-                int ringPos0 = static_cast<int>(pos0 % StreamingConstants::ringBufferFrames);
-                int ringPos1 = static_cast<int>(pos1 % StreamingConstants::ringBufferFrames);
+            auto p = static_cast<int64_t>(srcPos);
+            fracScratch[static_cast<size_t>(i)] = static_cast<float>(srcPos - static_cast<double>(p));
+            posScratch[static_cast<size_t>(i)] = static_cast<int>(p % ringFrames);
+            srcPos += pitchRatio;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < framesToRender; ++i)
+        {
+            auto p = static_cast<int>(srcPos);
+            fracScratch[static_cast<size_t>(i)] = static_cast<float>(srcPos - static_cast<double>(p));
+            posScratch[static_cast<size_t>(i)] = p;
+            srcPos += pitchRatio;
+        }
+    }
 
-                sample0 = ringBuffer.getSample(sourceChannel, ringPos0);
-                sample1 = ringBuffer.getSample(sourceChannel, ringPos1);
-            }
+    // ---- One tight interpolation loop per channel and kernel ----
 
-            // Linear interpolation
-            float interpolated = sample0 + frac * (sample1 - sample0);
+    // Ring indices wrap with a mask; a negative history tap in the first
+    // frames of a note lands on ring slots startVoice cleared to silence
+    static_assert((StreamingConstants::ringBufferFrames
+                   & (StreamingConstants::ringBufferFrames - 1)) == 0,
+                  "ring wrap relies on a power-of-two size");
+    auto wrap = [](int i) { return i & (StreamingConstants::ringBufferFrames - 1); };
 
-            // Apply velocity, envelope, and underrun fade
-            outputBuffer.addSample(ch, startSample + sample,
-                                    interpolated * velocity * envelopeValue * underrunFade);
-        }
+    const float* sincTable = Resampler::getSincTable();
 
-        // Advance source position
-        sourceSamplePosition += pitchRatio;
+    for (int ch = 0; ch < numOutputChannels; ++ch)
+    {
+        int sourceChannel = std::min(ch, numSourceChannels - 1);
+        float* out = outputBuffer.getWritePointer(ch, startSample);
 
-        // Update read position for ring buffer (whole frames consumed)
         if (isStreaming)
         {
-            int64_t newReadFrame = static_cast<int64_t>(sourceSamplePosition);
-            if (newReadFrame > currentReadPos)
+            const float* src = ringBuffer.getReadPointer(sourceChannel);
+
+            switch (quality)
+            {
+                case Resampler::Quality::live:
+                    for (int i = 0; i < framesToRender; ++i)
+                    {
+                        int idx0 = posScratch[static_cast<size_t>(i)];
+                        int idx1 = idx0 + 1;
+                        idx1 = (idx1 == ringFrames) ? 0 : idx1;
+
+                        float s0 = src[idx0];
+                        float s1 = src[idx1];
+                        out[i] += (s0 + fracScratch[static_cast<size_t>(i)] * (s1 - s0))
+                                  * gainScratch[static_cast<size_t>(i)];
+                    }
+                    break;
+
+                case Resampler::Quality::standard:
+                    for (int i = 0; i < framesToRender; ++i)
+                    {
+                        int idx0 = posScratch[static_cast<size_t>(i)];
+                        out[i] += Resampler::catmullRom(src[wrap(idx0 - 1)], src[idx0],
+                                                        src[wrap(idx0 + 1)], src[wrap(idx0 + 2)],
+                                                        fracScratch[static_cast<size_t>(i)])
+                                  * gainScratch[static_cast<size_t>(i)];
+                    }
+                    break;
+
+                case Resampler::Quality::high:
+                    for (int i = 0; i < framesToRender; ++i)
+                    {
+                        int idx0 = posScratch[static_cast<size_t>(i)];
+                        const float* row = Resampler::sincRowForFraction(
+                            sincTable, fracScratch[static_cast<size_t>(i)]);
+
+                        float acc = 0.0f;
+                        for (int tap = 0; tap < Resampler::sincTaps; ++tap)
+                            acc += row[tap] * src[wrap(idx0 - 3 + tap)];
+
+                        out[i] += acc * gainScratch[static_cast<size_t>(i)];
+                    }
+                    break;
+            }
+        }
+        else
+        {
+            const float* src = currentSample->preloadBuffer.getReadPointer(sourceChannel);
+            const int maxIndex = currentSample->preloadBuffer.getNumSamples() - 1;
+
+            for (int i = 0; i < framesToRender; ++i)
             {
-                currentReadPos = newReadFrame;
+                int idx0 = posScratch[static_cast<size_t>(i)];
+                out[i] += Resampler::interpolate(quality, sincTable,
+                              [src, idx0, maxIndex](int tap)
+                              {
+                                  return src[juce::jlimit(0, maxIndex, idx0 + tap)];
+                              },
+                              fracScratch[static_cast<size_t>(i)])
+                          * gainScratch[static_cast<size_t>(i)];
             }
         }
     }
 
-    // Update atomic read position after processing block
+    // ---- Advance state once per block ----
+
+    sourceSamplePosition = srcPos;
+
+    if (envelopeEnded || shedFadeEnded || isUnderrunning
+        || (!looping && sourceSamplePosition >= static_cast<double>(totalSourceFrames)))
+    {
+        reset();
+        return;
+    }
+
     if (isStreaming)
     {
-        readPosition.store(static_cast<int64_t>(sourceSamplePosition), std::memory_order_release);
+        // Clamp the consumed position to the write head: with pitch ratios
+        // above 1 the fractional source position can land fractionally past
+        // the last readable frame, and the reader must never claim to be
+        // ahead of the writer. Holding back by framesBehind keeps the
+        // kernel's history taps safe from the writer (the few frames of
+        // ring space this costs are noise against 32k).
+        int64_t consumed = static_cast<int64_t>(sourceSamplePosition)
+                           - Resampler::framesBehind(quality);
+        int64_t writeHead = writePosition.load(std::memory_order_acquire);
+        readPosition.store(juce::jlimit<int64_t>(0, writeHead, consumed),
+                           std::memory_order_release);
+
         checkAndRequestData();
 
-        // Periodic debug logging of ring buffer state
-        static int debugBlockCounter = 0;
-        if (++debugBlockCounter % 100 == 0)  // Every ~2 seconds at 512 samples/block
+        // Periodic ring buffer state trace (~every 2 seconds at 512/block)
+        if (++traceBlockCounter % 100 == 0)
         {
-            voiceDebugLog("Voice render: readPos=" + juce::String(readPosition.load())
-                         + " writePos=" + juce::String(writePosition.load())
-                         + " available=" + juce::String(samplesAvailable())
-                         + " sourcePos=" + juce::String(static_cast<int64_t>(sourceSamplePosition))
-                         + " / " + juce::String(totalSourceFrames)
-                         + " needsData=" + juce::String(needsData.load() ? "yes" : "no"));
+            Trace::post(Trace::Event::voiceRender, voiceIndex,
+                        readPosition.load(std::memory_order_relaxed),
+                        writePosition.load(std::memory_order_relaxed),
+                        samplesAvailable(),
+                        static_cast<juce::int64>(sourceSamplePosition));
         }
     }
 }
@@ -3,12 +3,29 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <atomic>
+#include <memory>
+#include <vector>
 #include "DiskStreaming.h"
+#include "StreamingMetrics.h"
+#include "Resampler.h"
 
 /**
  * StreamingVoice implements a voice that plays audio from a ring buffer
  * that is filled by a background disk thread.
  *
+ * Ring buffer protocol (wrap-safe for arbitrarily long files):
+ * - readPosition and writePosition are monotonic int64 frame counters in
+ *   source-file frames; they are never wrapped themselves. Source frame n
+ *   always lives in ring slot (n % ringBufferFrames), an invariant both
+ *   sides maintain: the disk thread writes frames at slots derived from its
+ *   file position, the audio thread reads at slots derived from its source
+ *   position, and distances are always computed as int64 differences of the
+ *   monotonic counters (bounded by ringBufferFrames, so they fit an int).
+ * - The writer only fills while (write - read) < ringBufferFrames, so it can
+ *   never lap the reader; the reader clamps rendering to frames behind the
+ *   write head, so it can never overrun the writer. A ten-minute sample
+ *   therefore streams indefinitely in constant ring memory.
+ *
  * Lock-free communication pattern:
  * - Audio thread: reads from ring buffer, updates readPosition (release)
  * - Disk thread: writes to ring buffer, updates writePosition (release)
@@ -22,6 +39,10 @@ public:
 
     // Voice lifecycle (called from audio thread)
     void startVoice(const PreloadedSample* sample, int midiNote, float velocity, double hostSampleRate);
+
+    // Keep the published instrument set this voice's sample lives in alive
+    // until the voice ends (RCU retirement; call just before startVoice)
+    void retainSampleSet(std::shared_ptr<const PreloadedSampleSet> set) { retainedSet = std::move(set); }
     void stopVoice(bool allowTailOff);
     void reset();
 
@@ -30,6 +51,17 @@ public:
     bool isActive() const { return active.load(std::memory_order_acquire); }
     int getPlayingNote() const { return playingNote; }
 
+    // Steal-selection accessors (audio thread only)
+    bool isReleasing() const { return releasing; }
+    float getEnvelopeLevel() const { return lastEnvelopeLevel; }
+    juce::uint32 getNoteStartMs() const { return noteStartMs; }
+    void applyStealFadeIn() { stealFadeSamples = stealFadeLength; }
+
+    // Governor load shedding: ramp this voice to silence over the next
+    // stealFadeLength samples, then free it (audio thread)
+    void beginShedFadeOut() { if (shedFadeSamples == 0) shedFadeSamples = stealFadeLength; }
+    bool isShedding() const { return shedFadeSamples > 0; }
+
     // Sustain pedal support
     void noteReleasedWithPedal(bool pedalDown);
     void setSustainPedal(bool isDown);
@@ -39,12 +71,26 @@ public:
     void setADSRParameters(const juce::ADSR::Parameters& params);
     void prepareToPlay(double sampleRate, int samplesPerBlock);
 
+    // Set the resampling quality for notes started after this call
+    // (running notes keep their kernel, and their read-position holdback)
+    void setResampleQuality(Resampler::Quality q) { pendingQuality = q; }
+
     // Ring buffer access for disk thread (thread-safe)
     int samplesAvailable() const;
     int spaceAvailable() const;
     bool needsMoreData() const { return needsData.load(std::memory_order_acquire); }
     void clearNeedsData() { needsData.store(false, std::memory_order_release); }
 
+    // Wire this voice to the disk thread's request queue (called at registration)
+    void setRequestQueue(StreamRequestQueue* queue, int indexInStreamer)
+    {
+        requestQueue = queue;
+        voiceIndex = indexInStreamer;
+    }
+
+    // Health counters shared across the engine (may be null in tests)
+    void setMetrics(StreamingMetrics* m) { metrics = m; }
+
     // Disk thread fills buffer here
     float* getWritePointer(int channel);
     int getWritePosition() const { return static_cast<int>(writePosition.load(std::memory_order_acquire) % StreamingConstants::ringBufferFrames); }
@@ -63,10 +109,19 @@ public:
     // Sample info for disk thread
     const PreloadedSample* getCurrentSample() const { return currentSample; }
 
+    // Consumption rate, for the disk thread's starvation-deadline ordering.
+    // Written in startVoice before the voice goes active, stable afterwards.
+    double getPitchRatio() const { return pitchRatio; }
+
 private:
     // Current sample being played (set at voice start, read by disk thread)
     const PreloadedSample* currentSample = nullptr;
 
+    // Reference on the instrument set currentSample lives in; dropping it on
+    // reset() is just a refcount decrement - the processor's retire list
+    // holds the last reference, so destruction never lands on this thread
+    std::shared_ptr<const PreloadedSampleSet> retainedSet;
+
     // Ring buffer for streaming audio (stereo capable)
     juce::AudioBuffer<float> ringBuffer;
 
@@ -93,11 +148,44 @@ private:
     juce::ADSR adsr;
     bool sustainedByPedal = false;
 
-    // Underrun protection
+    // Underrun protection: set when the ring can't cover a whole block; the
+    // voice fades its remaining frames to silence and ends at block end
     bool isUnderrunning = false;
-    int underrunFadePosition = 0;
+
+    // Resampling kernel, latched from pendingQuality at note start. The
+    // kernel's history taps read ring slots just behind the play head, so
+    // the consumed read position is held back by framesBehind(quality) to
+    // keep the disk thread from overwriting them.
+    Resampler::Quality pendingQuality = Resampler::Quality::standard;
+    Resampler::Quality quality = Resampler::Quality::standard;
+
+    // Steal-selection state (audio thread only)
+    static constexpr int stealFadeLength = 64;
+    bool releasing = false;
+    float lastEnvelopeLevel = 0.0f;
+    juce::uint32 noteStartMs = 0;
+    int stealFadeSamples = 0;
+    int shedFadeSamples = 0;  // governor fade-out; counts down to the cull
+
+    // Per-block scratch arrays (sized in prepareToPlay) so the hot render loop
+    // can run branch-free: envelope/gain ramp, source indices and fractions
+    // are all resolved up front, then each channel is one tight loop.
+    std::vector<float> gainScratch;
+    std::vector<float> fracScratch;
+    std::vector<int> posScratch;
+
+    // Request queue shared with the disk thread (owned by DiskStreamer)
+    StreamRequestQueue* requestQueue = nullptr;
+    int voiceIndex = -1;
+
+    // Engine-wide health counters (owned by the processor)
+    StreamingMetrics* metrics = nullptr;
+
+    // Gates the periodic ring-state trace event (audio thread only)
+    int traceBlockCounter = 0;
 
     // Internal helpers
     void checkAndRequestData();
+    void signalNeedsData();
     float readFromRingBuffer(int channel, int ringPos);
 };
@@ -0,0 +1,250 @@
+#include "Trace.h"
+#include <array>
+
+namespace Trace
+{
+
+// One preformatted POD record. Producers fill the numeric fields only;
+// all string formatting happens on the drain thread.
+struct TraceRecord
+{
+    juce::uint32 timeMs = 0;
+    Event type = Event::noteOn;
+    juce::int16 voiceIndex = -1;
+    juce::int64 a = 0, b = 0, c = 0, d = 0;
+};
+
+// Bounded multi-producer single-consumer ring (Vyukov-style): each cell
+// carries a sequence number that tells producers whether it is free and the
+// consumer whether it is filled, so neither side ever takes a lock.
+struct Cell
+{
+    std::atomic<juce::uint32> sequence{0};
+    TraceRecord record;
+};
+
+static constexpr juce::uint32 ringSize = 4096;  // power of two
+static constexpr juce::uint32 ringMask = ringSize - 1;
+
+class TraceBuffer : private juce::Thread
+{
+public:
+    TraceBuffer() : juce::Thread("TraceDrain")
+    {
+        for (juce::uint32 i = 0; i < ringSize; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~TraceBuffer() override
+    {
+        setEnabled(false);
+    }
+
+    void setEnabled(bool shouldTrace)
+    {
+        if (shouldTrace == enabled.load(std::memory_order_relaxed))
+            return;
+
+        if (shouldTrace)
+        {
+            auto traceFile = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+                                 .getChildFile("sampler_trace.txt");
+            output = traceFile.createOutputStream();
+
+            enabled.store(true, std::memory_order_release);
+            startThread(juce::Thread::Priority::low);
+        }
+        else
+        {
+            enabled.store(false, std::memory_order_release);
+            stopThread(1000);
+
+            drain();  // flush whatever producers managed to post
+            output.reset();
+        }
+    }
+
+    bool isEnabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void post(Event type, int voiceIndex,
+              juce::int64 a, juce::int64 b, juce::int64 c, juce::int64 d)
+    {
+        // Claim a cell. A producer may race with others here, so the claim
+        // is a CAS on the enqueue position; the loop only repeats when
+        // another producer won the same slot.
+        juce::uint32 pos = enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell& cell = cells[pos & ringMask];
+            juce::uint32 seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<juce::int32>(seq - pos);
+
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.record.timeMs = juce::Time::getMillisecondCounter();
+                    cell.record.type = type;
+                    cell.record.voiceIndex = static_cast<juce::int16>(voiceIndex);
+                    cell.record.a = a;
+                    cell.record.b = b;
+                    cell.record.c = c;
+                    cell.record.d = d;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Ring full: drop rather than block a realtime thread
+                droppedEvents.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            drain();
+            wait(100);
+        }
+    }
+
+    // Single consumer: only the drain thread (or setEnabled(false) after the
+    // thread has stopped) ever calls this
+    void drain()
+    {
+        if (output == nullptr)
+            return;
+
+        bool wroteAnything = false;
+
+        for (;;)
+        {
+            Cell& cell = cells[dequeuePos & ringMask];
+            juce::uint32 seq = cell.sequence.load(std::memory_order_acquire);
+
+            if (static_cast<juce::int32>(seq - (dequeuePos + 1)) != 0)
+                break;  // nothing filled yet
+
+            writeRecord(cell.record);
+            wroteAnything = true;
+
+            cell.sequence.store(dequeuePos + ringSize, std::memory_order_release);
+            ++dequeuePos;
+        }
+
+        auto dropped = droppedEvents.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0)
+        {
+            output->writeText("!! dropped " + juce::String(dropped) + " events (ring full)\n",
+                              false, false, nullptr);
+            wroteAnything = true;
+        }
+
+        if (wroteAnything)
+            output->flush();
+    }
+
+    void writeRecord(const TraceRecord& r)
+    {
+        juce::String line;
+        line.preallocateBytes(128);
+
+        line << "[" << juce::String(r.timeMs) << "]";
+        if (r.voiceIndex >= 0)
+            line << " v" << juce::String(r.voiceIndex);
+
+        switch (r.type)
+        {
+            case Event::noteOn:
+                line << " noteOn note=" << juce::String(r.a) << " vel=" << juce::String(r.b)
+                     << " rr=" << juce::String(r.c) << "/" << juce::String(r.d);
+                break;
+            case Event::noteOnStreaming:
+                line << " noteOnStreaming note=" << juce::String(r.a) << " vel=" << juce::String(r.b)
+                     << " rr=" << juce::String(r.c) << "/" << juce::String(r.d);
+                break;
+            case Event::voiceStart:
+                line << " voiceStart note=" << juce::String(r.a)
+                     << " totalFrames=" << juce::String(r.b)
+                     << " preloadFrames=" << juce::String(r.c)
+                     << " pitchRatioMilli=" << juce::String(r.d);
+                break;
+            case Event::voiceRender:
+                line << " render readPos=" << juce::String(r.a)
+                     << " writePos=" << juce::String(r.b)
+                     << " available=" << juce::String(r.c)
+                     << " sourcePos=" << juce::String(r.d);
+                break;
+            case Event::fillEnter:
+                line << " fillEnter filePos=" << juce::String(r.a);
+                break;
+            case Event::fillExit:
+                line << " fillExit filled=" << juce::String(r.a)
+                     << " filePos=" << juce::String(r.b) << "/" << juce::String(r.c)
+                     << " eof=" << (r.d != 0 ? "yes" : "no");
+                break;
+            case Event::warmed:
+                line << " warmed frames=" << juce::String(r.a);
+                break;
+            case Event::streamerStarted:
+                line << " diskStreamer started";
+                break;
+            case Event::streamerStopped:
+                line << " diskStreamer stopped";
+                break;
+        }
+
+        line << "\n";
+        output->writeText(line, false, false, nullptr);
+    }
+
+    std::array<Cell, ringSize> cells;
+    std::atomic<juce::uint32> enqueuePos{0};
+    juce::uint32 dequeuePos = 0;  // consumer only
+
+    std::atomic<juce::uint32> droppedEvents{0};
+    std::atomic<bool> enabled{false};
+
+    std::unique_ptr<juce::FileOutputStream> output;
+};
+
+static TraceBuffer& buffer()
+{
+    static TraceBuffer instance;
+    return instance;
+}
+
+void setEnabled(bool shouldTrace)
+{
+    buffer().setEnabled(shouldTrace);
+}
+
+bool isEnabled()
+{
+    return buffer().isEnabled();
+}
+
+void post(Event type, int voiceIndex,
+          juce::int64 a, juce::int64 b, juce::int64 c, juce::int64 d)
+{
+    auto& buf = buffer();
+    if (!buf.isEnabled())
+        return;
+
+    buf.post(type, voiceIndex, a, b, c, d);
+}
+
+} // namespace Trace
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+/**
+ * Lock-free tracing for the audio and disk hot paths.
+ *
+ * The old debug loggers opened and appended to a text file (with timestamp
+ * formatting and String allocation) from inside renderNextBlock and
+ * fillVoiceBuffer - enough filesystem traffic to glitch a session on a slow
+ * disk. Tracing replaces them with fixed-size POD records pushed into a
+ * bounded lock-free ring; a low-priority drain thread formats and writes
+ * them out. The subsystem is compiled in but off by default: when disabled,
+ * posting an event is a single relaxed atomic load and an early return.
+ *
+ * Producers may be the audio thread, the disk thread and the message thread
+ * simultaneously (multi-producer, single consumer). When the ring is full
+ * events are dropped and counted, never blocked on.
+ */
+namespace Trace
+{
+    enum class Event : juce::uint16
+    {
+        noteOn,             // a=midiNote, b=velocity(0-127), c=rrIndex, d=numMatches
+        noteOnStreaming,    // a=midiNote, b=velocity(0-127), c=rrIndex, d=numMatches
+        voiceStart,         // a=midiNote, b=totalFrames, c=preloadFrames, d=pitchRatio*1000
+        voiceRender,        // a=readPos, b=writePos, c=available, d=sourcePos
+        fillEnter,          // a=filePos
+        fillExit,           // a=framesFilled, b=filePos, c=totalFrames, d=eof(0/1)
+        warmed,             // a=framesWarmed
+        streamerStarted,
+        streamerStopped
+    };
+
+    /** Enables or disables tracing at runtime. Enabling starts the drain
+        thread and opens the trace file; disabling flushes and stops it. */
+    void setEnabled(bool shouldTrace);
+
+    bool isEnabled();
+
+    /** Posts one event. Safe from any thread, wait-free, never allocates;
+        a no-op when tracing is disabled. voiceIndex is -1 where there is
+        no associated voice. */
+    void post(Event type, int voiceIndex,
+              juce::int64 a = 0, juce::int64 b = 0,
+              juce::int64 c = 0, juce::int64 d = 0);
+}
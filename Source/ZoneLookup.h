@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+
+/**
+ * ZoneLookup is a precomputed note-on resolution index.
+ *
+ * It maps each of the 128 MIDI notes to a span of zone indices sorted by
+ * velocity range, so note-on resolution is a table lookup plus a binary
+ * search over that note's velocity layers instead of a linear scan (and
+ * dynamic_cast) over every zone in the instrument.
+ *
+ * Built once on the message thread when an instrument (re)loads; queried
+ * from the audio thread with zero allocation - matches are written into a
+ * caller-provided fixed array.
+ */
+class ZoneLookup
+{
+public:
+    // Upper bound on matches returned per note-on (velocity layers * round robins)
+    static constexpr int maxMatchesPerNote = 128;
+
+    /** Start a rebuild, discarding the previous index. */
+    void beginBuild()
+    {
+        building.clear();
+    }
+
+    /** Register one zone. The index is whatever the caller resolves matches
+        back into (sound index for the RAM path, sample index for streaming). */
+    void addZone(int index, int lowNote, int highNote, int lowVelocity, int highVelocity)
+    {
+        building.push_back({ index, lowNote, highNote, lowVelocity, highVelocity });
+    }
+
+    /** Distribute registered zones into the per-note table. */
+    void finishBuild()
+    {
+        entries.clear();
+        entries.reserve(building.size());  // lower bound; wide zones appear per note
+
+        for (int note = 0; note < 128; ++note)
+        {
+            auto& span = noteSpans[static_cast<size_t>(note)];
+            span.start = static_cast<int>(entries.size());
+
+            for (const auto& zone : building)
+            {
+                if (note >= zone.lowNote && note <= zone.highNote)
+                    entries.push_back({ zone.index, zone.lowVelocity, zone.highVelocity });
+            }
+
+            span.length = static_cast<int>(entries.size()) - span.start;
+
+            // Sort this note's layers by velocity floor, zone index as tie-break
+            // so round-robin groups keep a stable order
+            std::sort(entries.begin() + span.start, entries.end(),
+                      [](const Entry& a, const Entry& b)
+                      {
+                          if (a.lowVelocity != b.lowVelocity)
+                              return a.lowVelocity < b.lowVelocity;
+                          return a.index < b.index;
+                      });
+        }
+
+        building.clear();
+        building.shrink_to_fit();
+    }
+
+    /** Clear the index (no instrument loaded). */
+    void clear()
+    {
+        building.clear();
+        entries.clear();
+        noteSpans.fill({});
+    }
+
+    /** Write the indices of all zones matching note+velocity into out.
+        Returns the number of matches (0 if none). Allocation-free. */
+    int findMatches(int midiNote, int velocity, int* out, int maxOut) const
+    {
+        if (midiNote < 0 || midiNote > 127)
+            return 0;
+
+        const auto& span = noteSpans[static_cast<size_t>(midiNote)];
+        auto begin = entries.begin() + span.start;
+        auto end = begin + span.length;
+
+        // Entries past this point have a velocity floor above us
+        auto cutoff = std::upper_bound(begin, end, velocity,
+                                       [](int v, const Entry& e) { return v < e.lowVelocity; });
+
+        int numMatches = 0;
+        for (auto it = begin; it != cutoff && numMatches < maxOut; ++it)
+        {
+            if (velocity <= it->highVelocity)
+                out[numMatches++] = it->index;
+        }
+
+        return numMatches;
+    }
+
+private:
+    struct Entry
+    {
+        int index = 0;
+        int lowVelocity = 1;
+        int highVelocity = 127;
+    };
+
+    struct BuildingZone
+    {
+        int index;
+        int lowNote, highNote;
+        int lowVelocity, highVelocity;
+    };
+
+    struct Span
+    {
+        int start = 0;
+        int length = 0;
+    };
+
+    std::vector<BuildingZone> building;
+    std::vector<Entry> entries;
+    std::array<Span, 128> noteSpans{};
+};